@@ -21,6 +21,7 @@
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/PostProcessor.hpp"
+#include "libslic3r/GCode/ThumbnailRenderer.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Preset.hpp"
 #include <arrange-wrapper/ModelArrange.hpp>
@@ -199,57 +200,63 @@ static ThumbnailData resize_and_crop(const std::vector<unsigned char>& data, int
 }
 
 
-static std::function<ThumbnailsList(const ThumbnailsParams&)> get_thumbnail_generator_cli(const std::string& filename)
+// Thumbnail stored in a 3MF file, resized to params.sizes. Returns an empty list if the file contains no thumbnail.
+static ThumbnailsList get_thumbnails_from_3mf(const std::string& filename, const ThumbnailsParams& params)
 {
-    if (boost::iends_with(filename, ".3mf")) {
-        return [filename](const ThumbnailsParams& params) {
-            ThumbnailsList list_out;
-
-            mz_zip_archive archive;
-            mz_zip_zero_struct(&archive);
-
-            if (!open_zip_reader(&archive, filename))
-                return list_out;
-            mz_uint num_entries = mz_zip_reader_get_num_files(&archive);
-            mz_zip_archive_file_stat stat;
-
-            int index = mz_zip_reader_locate_file(&archive, "Metadata/thumbnail.png", nullptr, 0);
-            if (index < 0 || !mz_zip_reader_file_stat(&archive, index, &stat))
-                return list_out;
-            std::string buffer;
-            buffer.resize(int(stat.m_uncomp_size));
-            mz_bool res = mz_zip_reader_extract_file_to_mem(&archive, stat.m_filename, buffer.data(), (size_t)stat.m_uncomp_size, 0);
-            if (res == 0)
-                return list_out;
-            close_zip_reader(&archive);
-
-            std::vector<unsigned char> data;
-            unsigned width = 0;
-            unsigned height = 0;
-            png::decode_png(buffer, data, width, height);
-
-            {
-                // Flip the image vertically so it matches the convention in Thumbnails generator.
-                const int row_size = width * 4; // Each pixel is 4 bytes (RGBA)
-                std::vector<unsigned char> temp_row(row_size);
-                for (int i = 0; i < height / 2; ++i) {
-                    unsigned char* top_row = &data[i * row_size];
-                    unsigned char* bottom_row = &data[(height - i - 1) * row_size];
-                    std::copy(bottom_row, bottom_row + row_size, temp_row.begin());
-                    std::copy(top_row, top_row + row_size, bottom_row);
-                    std::copy(temp_row.begin(), temp_row.end(), top_row);
-                }
-            }
+    ThumbnailsList list_out;
+
+    mz_zip_archive archive;
+    mz_zip_zero_struct(&archive);
+
+    if (!open_zip_reader(&archive, filename))
+        return list_out;
+    mz_uint num_entries = mz_zip_reader_get_num_files(&archive);
+    mz_zip_archive_file_stat stat;
+
+    int index = mz_zip_reader_locate_file(&archive, "Metadata/thumbnail.png", nullptr, 0);
+    if (index < 0 || !mz_zip_reader_file_stat(&archive, index, &stat))
+        return list_out;
+    std::string buffer;
+    buffer.resize(int(stat.m_uncomp_size));
+    mz_bool res = mz_zip_reader_extract_file_to_mem(&archive, stat.m_filename, buffer.data(), (size_t)stat.m_uncomp_size, 0);
+    if (res == 0)
+        return list_out;
+    close_zip_reader(&archive);
+
+    std::vector<unsigned char> data;
+    unsigned width = 0;
+    unsigned height = 0;
+    png::decode_png(buffer, data, width, height);
+
+    {
+        // Flip the image vertically so it matches the convention in Thumbnails generator.
+        const int row_size = width * 4; // Each pixel is 4 bytes (RGBA)
+        std::vector<unsigned char> temp_row(row_size);
+        for (int i = 0; i < height / 2; ++i) {
+            unsigned char* top_row = &data[i * row_size];
+            unsigned char* bottom_row = &data[(height - i - 1) * row_size];
+            std::copy(bottom_row, bottom_row + row_size, temp_row.begin());
+            std::copy(top_row, top_row + row_size, bottom_row);
+            std::copy(temp_row.begin(), temp_row.end(), top_row);
+        }
+    }
 
-            for (const Vec2d& size : params.sizes) {
-                Point isize(size);
-                list_out.push_back(resize_and_crop(data, width, height, isize.x(), isize.y()));
-            }
-            return list_out;
-        };
+    for (const Vec2d& size : params.sizes) {
+        Point isize(size);
+        list_out.push_back(resize_and_crop(data, width, height, isize.x(), isize.y()));
     }
+    return list_out;
+}
 
-    return [](const ThumbnailsParams&) ->ThumbnailsList { return {}; };
+static std::function<ThumbnailsList(const ThumbnailsParams&)> get_thumbnail_generator_cli(const std::string& filename, const Print& print)
+{
+    return [filename, &print](const ThumbnailsParams& params) {
+        if (boost::iends_with(filename, ".3mf"))
+            if (ThumbnailsList list_out = get_thumbnails_from_3mf(filename, params); ! list_out.empty())
+                return list_out;
+        // No thumbnail to reuse, render the objects in software as there is no OpenGL context in the CLI.
+        return GCodeThumbnails::render_thumbnails(print, params);
+    };
 }
 
 static void update_instances_outside_state(Model& model, const DynamicPrintConfig& config)
@@ -362,6 +369,8 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
             if (printer_technology == ptFFF) {
                 for (auto* mo : model.objects)
                     fff_print.auto_assign_extruders(mo);
+                if (cli.misc_config.has("memory_budget"))
+                    fff_print.set_memory_budget(size_t(cli.misc_config.opt_int("memory_budget")) << 20);
             }
 
             update_instances_outside_state(model, print_config);
@@ -387,7 +396,7 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
                 if (printer_technology == ptFFF) {
                     // The outfile is processed by a PlaceholderParser.
                     const std::string input_file = fff_print.model().objects.empty() ? "" : fff_print.model().objects.front()->input_file;
-                    outfile = fff_print.export_gcode(outfile, nullptr, get_thumbnail_generator_cli(input_file));
+                    outfile = fff_print.export_gcode(outfile, nullptr, get_thumbnail_generator_cli(input_file, fff_print));
                     outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
                 }
                 else {
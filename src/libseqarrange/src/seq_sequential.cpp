@@ -9008,6 +9008,83 @@ bool checkExtens_SequentialWeakPolygonNonoverlapping(coord_t
 }
 
 
+/*
+ * Positions of the undecided objects accepted for a larger bounding box (or polygon) already
+ * satisfy all the nonoverlapping constraints, so if they also fit into a smaller one, they can
+ * be reused without calling the solver again. The check is done outside of the solver context
+ * and conservatively, positions close to the boundary are left for the solver.
+ */
+bool checkFit_ConsequentialWeakPolygonNonoverlapping(coord_t                             box_min_x,
+						     coord_t                             box_min_y,
+						     coord_t                             box_max_x,
+						     coord_t                             box_max_y,
+						     const std::vector<Rational>        &dec_values_X,
+						     const std::vector<Rational>        &dec_values_Y,
+						     const std::vector<int>             &undecided,
+						     const std::vector<Slic3r::Polygon> &polygons)
+{
+    for (unsigned int i = 0; i < undecided.size(); ++i)
+    {
+	BoundingBox polygon_box = get_extents(polygons[undecided[i]]);
+
+	double x = dec_values_X[undecided[i]].as_double();
+	double y = dec_values_Y[undecided[i]].as_double();
+
+	if (   x + polygon_box.min.x() < box_min_x + EPSILON
+	    || x + polygon_box.max.x() > box_max_x - EPSILON
+	    || y + polygon_box.min.y() < box_min_y + EPSILON
+	    || y + polygon_box.max.y() > box_max_y - EPSILON)
+	{
+	    return false;
+	}
+    }
+    return true;
+}
+
+
+bool checkFit_ConsequentialWeakPolygonNonoverlapping(const Slic3r::Polygon              &bounding_polygon,
+						     const std::vector<Rational>        &dec_values_X,
+						     const std::vector<Rational>        &dec_values_Y,
+						     const std::vector<int>             &undecided,
+						     const std::vector<Slic3r::Polygon> &polygons)
+{
+    for (unsigned int i = 0; i < undecided.size(); ++i)
+    {
+	BoundingBox polygon_box = get_extents(polygons[undecided[i]]);
+
+	double x = dec_values_X[undecided[i]].as_double();
+	double y = dec_values_Y[undecided[i]].as_double();
+
+	const double corners[4][2] = { { x + polygon_box.min.x(), y + polygon_box.min.y() },
+				       { x + polygon_box.max.x(), y + polygon_box.min.y() },
+				       { x + polygon_box.max.x(), y + polygon_box.max.y() },
+				       { x + polygon_box.min.x(), y + polygon_box.max.y() } };
+
+	for (Points::const_iterator point = bounding_polygon.points.begin(); point != bounding_polygon.points.end(); ++point)
+	{
+	    Points::const_iterator next_point = point + 1;
+	    if (next_point == bounding_polygon.points.end())
+	    {
+		next_point = bounding_polygon.points.begin();
+	    }
+
+	    Line line(*point, *next_point);
+	    Vector normal = line.normal();
+
+	    for (unsigned int c = 0; c < 4; ++c)
+	    {
+		if (  normal.x() * (corners[c][0] - line.a.x())
+		    + normal.y() * (corners[c][1] - line.a.y()) > -EPSILON)
+		{
+		    return false;
+		}
+	    }
+	}
+    }
+    return true;
+}
+
+
 bool optimize_SequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver                                       &Solver,
 								z3::context                                      &Context,
 								const SolverConfiguration                        &solver_configuration,
@@ -9393,15 +9470,28 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	}	
 
 	bool sat = false;
-
-	if (checkArea_SequentialWeakPolygonNonoverlapping(box_min_x,
-							  box_min_y,
-							  box_max_x,
-							  box_max_y,
-							  fixed,
-							  undecided,	       
-							  polygons,
-							  unreachable_polygons))
+	bool fits = false;
+
+	if (   last_solvable_bounding_box_size > 0
+	    && checkFit_ConsequentialWeakPolygonNonoverlapping(box_min_x,
+							       box_min_y,
+							       box_max_x,
+							       box_max_y,
+							       dec_values_X,
+							       dec_values_Y,
+							       undecided,
+							       polygons))
+	{
+	    fits = true;
+	}
+	else if (checkArea_SequentialWeakPolygonNonoverlapping(box_min_x,
+							       box_min_y,
+							       box_max_x,
+							       box_max_y,
+							       fixed,
+							       undecided,	       
+							       polygons,
+							       unreachable_polygons))
 	{	    
 	    switch (Solver.check(complete_assumptions))
 	    {
@@ -9431,7 +9521,16 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	    sat = false;
 	}
 
-	if (sat)
+	if (fits)
+	{
+	    #ifdef DEBUG
+	    {
+		printf("Previous positions fit\n");
+	    }
+	    #endif
+	    size_solvable = true;
+	}
+	else if (sat)
 	{
 	    #ifdef DEBUG
 	    {
@@ -9707,15 +9806,28 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	}	
 
 	bool sat = false;
-
-	if (checkArea_SequentialWeakPolygonNonoverlapping(box_min_x,
-							  box_min_y,
-							  box_max_x,
-							  box_max_y,
-							  fixed,
-							  undecided,	       
-							  polygons,
-							  unreachable_polygons))
+	bool fits = false;
+
+	if (   solving_result
+	    && checkFit_ConsequentialWeakPolygonNonoverlapping(box_min_x,
+							       box_min_y,
+							       box_max_x,
+							       box_max_y,
+							       dec_values_X,
+							       dec_values_Y,
+							       undecided,
+							       polygons))
+	{
+	    fits = true;
+	}
+	else if (checkArea_SequentialWeakPolygonNonoverlapping(box_min_x,
+							       box_min_y,
+							       box_max_x,
+							       box_max_y,
+							       fixed,
+							       undecided,	       
+							       polygons,
+							       unreachable_polygons))
 	{	    
 	    switch (Solver.check(complete_assumptions))
 	    {
@@ -9745,7 +9857,16 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	    sat = false;
 	}
 
-	if (sat)
+	if (fits)
+	{
+	    #ifdef DEBUG
+	    {
+		printf("Previous positions fit\n");
+	    }
+	    #endif
+	    size_solvable = true;
+	}
+	else if (sat)
 	{
 	    #ifdef DEBUG
 	    {
@@ -10063,12 +10184,22 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	}	
 
 	bool sat = false;
+	bool fits = false;
 
-	if (checkArea_SequentialWeakPolygonNonoverlapping(bounding_polygon,
-							  fixed,
-							  undecided,	       
-							  polygons,
-							  unreachable_polygons))
+	if (   solving_result
+	    && checkFit_ConsequentialWeakPolygonNonoverlapping(bounding_polygon,
+							       dec_values_X,
+							       dec_values_Y,
+							       undecided,
+							       polygons))
+	{
+	    fits = true;
+	}
+	else if (checkArea_SequentialWeakPolygonNonoverlapping(bounding_polygon,
+							       fixed,
+							       undecided,	       
+							       polygons,
+							       unreachable_polygons))
 	{
 	    switch (Solver.check(complete_assumptions))
 	    {
@@ -10098,7 +10229,16 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	    sat = false;
 	}
 
-	if (sat)
+	if (fits)
+	{
+	    #ifdef DEBUG
+	    {
+		printf("Previous positions fit\n");
+	    }
+	    #endif
+	    size_solvable = true;
+	}
+	else if (sat)
 	{
 	    #ifdef DEBUG
 	    {
@@ -1495,6 +1495,21 @@ bool checkExtens_SequentialWeakPolygonNonoverlapping(coord_t
 						     const std::vector<Slic3r::Polygon>               &polygons,
 						     const std::vector<std::vector<Slic3r::Polygon> > &unreachable_polygons);
 
+bool checkFit_ConsequentialWeakPolygonNonoverlapping(coord_t                             box_min_x,
+						     coord_t                             box_min_y,
+						     coord_t                             box_max_x,
+						     coord_t                             box_max_y,
+						     const std::vector<Rational>        &dec_values_X,
+						     const std::vector<Rational>        &dec_values_Y,
+						     const std::vector<int>             &undecided,
+						     const std::vector<Slic3r::Polygon> &polygons);
+
+bool checkFit_ConsequentialWeakPolygonNonoverlapping(const Slic3r::Polygon              &bounding_polygon,
+						     const std::vector<Rational>        &dec_values_X,
+						     const std::vector<Rational>        &dec_values_Y,
+						     const std::vector<int>             &undecided,
+						     const std::vector<Slic3r::Polygon> &polygons);
+
 bool optimize_SequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver                                       &Solver,
 								z3::context                                      &Context,
 								const SolverConfiguration                        &solver_configuration,
@@ -25,6 +25,8 @@
 
 #include <z3++.h>
 
+#include "prusaparts.hpp"
+
 #include "libseqarrange/seq_interface.hpp"
 #include "seq_utilities.hpp"
 #include "seq_preprocess.hpp"
@@ -1249,4 +1251,64 @@ TEST_CASE("Interface test 6", "[Sequential Arrangement Interface]")
 
 /*----------------------------------------------------------------*/
 
+TEST_CASE("Interface test 7", "[Sequential Arrangement Interface][Slow]")
+//void interface_test_7(void)
+{
+    clock_t start, finish;
+    
+    INFO("Testing interface 7 ...");
+
+    SolverConfiguration solver_configuration;
+    solver_configuration.plate_bounding_box = BoundingBox({0,0}, {SEQ_PRUSA_MK3S_X_SIZE / SEQ_SLICER_SCALE_FACTOR, SEQ_PRUSA_MK3S_Y_SIZE / SEQ_SLICER_SCALE_FACTOR});
+
+    const int object_counts[] = {8, 16, 24, 32};
+
+    for (int object_count: object_counts)
+    {
+	std::vector<ObjectToPrint> objects_to_print;
+
+	for (int i = 0; i < object_count; ++i)
+	{
+	    ObjectToPrint object_to_print;
+	    object_to_print.id = i;
+	    object_to_print.total_height = 2000000;
+	    object_to_print.pgns_at_height.push_back({0, PRUSA_PART_POLYGONS[i % PRUSA_PART_POLYGONS.size()]});
+
+	    objects_to_print.push_back(object_to_print);
+	}
+
+	std::vector<ScheduledPlate> scheduled_plates;
+
+	start = clock();
+	int result = schedule_ObjectsForSequentialPrint(solver_configuration,
+							objects_to_print,
+							scheduled_plates);
+	finish = clock();
+
+	printf("Objects: %d, plates: %ld, solving time: %.3f\n", object_count, scheduled_plates.size(), (finish - start) / (double)CLOCKS_PER_SEC);
+
+	REQUIRE(result == 0);
+	REQUIRE(scheduled_plates.size() > 0);
 
+	int scheduled_count = 0;
+	for (unsigned int plate = 0; plate < scheduled_plates.size(); ++plate)
+	{
+	    REQUIRE(scheduled_plates[plate].scheduled_objects.size() > 0);
+
+	    for (const auto& scheduled_object: scheduled_plates[plate].scheduled_objects)
+	    {
+		REQUIRE(scheduled_object.x >= solver_configuration.plate_bounding_box.min.x() * SEQ_SLICER_SCALE_FACTOR);
+		REQUIRE(scheduled_object.x <= solver_configuration.plate_bounding_box.max.x() * SEQ_SLICER_SCALE_FACTOR);
+		REQUIRE(scheduled_object.y >= solver_configuration.plate_bounding_box.min.y() * SEQ_SLICER_SCALE_FACTOR);
+		REQUIRE(scheduled_object.y <= solver_configuration.plate_bounding_box.max.y() * SEQ_SLICER_SCALE_FACTOR);
+		++scheduled_count;
+	    }
+	}
+	REQUIRE(scheduled_count == object_count);
+    }
+
+    INFO("Testing interface 7 ... finished");
+}
+
+
+/*----------------------------------------------------------------*/
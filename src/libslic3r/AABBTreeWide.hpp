@@ -0,0 +1,380 @@
+// Wide (4-ary) bounding volume hierarchy collapsed from AABBTreeIndirect::Tree for fast ray casting
+// over indexed triangle sets. The bounding boxes of the children of a node are stored as structure
+// of arrays in single precision, so that a ray is tested against all the children of a node at once
+// by a loop the compiler vectorizes. Batches of coherent rays (sharing an origin or having similar
+// directions) are traversed as packets, amortizing the node fetches and box tests over the rays.
+
+#ifndef slic3r_AABBTreeWide_hpp_
+#define slic3r_AABBTreeWide_hpp_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "AABBTreeIndirect.hpp"
+
+// SSE2 is supported by any x64 processor, other platforms use a plain loop for the ray / box tests.
+#if defined(__SSE2__) || defined(_M_X64)
+    #define SLIC3R_AABB_WIDE_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace Slic3r {
+namespace AABBTreeIndirect {
+
+template<int AWidth>
+class WideTree
+{
+public:
+    static constexpr int Width = AWidth;
+
+    enum : uint32_t {
+        // Child slot is not used.
+        empty_slot = uint32_t(-1),
+        // Child slot references a leaf, the rest of the bits store the index of the external source entity.
+        leaf_flag  = uint32_t(1) << 31
+    };
+
+    // Bounding boxes of the children as structure of arrays, aligned for SSE loads. Unused slots have inverted infinite boxes
+    // (min = +infinity, max = -infinity), so that they never pass the ray / box test.
+    struct alignas(32) Node {
+        float    min[3][Width];
+        float    max[3][Width];
+        uint32_t child[Width];
+    };
+
+    void clear() { m_nodes.clear(); }
+    bool empty() const { return m_nodes.empty(); }
+    const std::vector<Node>& nodes() const { return m_nodes; }
+    const Node&              node(size_t idx) const { return m_nodes[idx]; }
+
+    static bool     is_leaf(uint32_t child) { return child != empty_slot && (child & leaf_flag) != 0; }
+    static uint32_t leaf_idx(uint32_t child) { assert(is_leaf(child)); return child & ~leaf_flag; }
+
+    // Collapse a binary tree into a wide tree. The binary tree is not needed for the traversal of the wide tree
+    // afterwards, thus it may be released by the caller.
+    template<typename CoordType>
+    void build(const Tree<3, CoordType> &tree)
+    {
+        m_nodes.clear();
+        if (tree.empty())
+            return;
+        assert(tree.nodes().size() < size_t(leaf_flag));
+        // The bounding boxes are rounded to floats, inflate them a bit so that no ray hit is missed.
+        const auto &root_bbox = tree.node(0).bbox;
+        m_bbox_eps = 4.f * std::numeric_limits<float>::epsilon() *
+            float(std::max(root_bbox.min().cwiseAbs().maxCoeff(), root_bbox.max().cwiseAbs().maxCoeff()));
+        // Reserve for the worst case of a binary tree with all inner nodes having only two children.
+        m_nodes.reserve(tree.nodes().size() / 2 + 1);
+        if (tree.node(0).is_leaf()) {
+            Node &root = m_nodes.emplace_back(empty_node());
+            set_child(root, 0, tree, 0);
+            root.child[0] = uint32_t(tree.node(0).idx) | leaf_flag;
+        } else
+            build_recursive(tree, 0);
+        m_nodes.shrink_to_fit();
+    }
+
+private:
+    static Node empty_node()
+    {
+        Node node;
+        for (int d = 0; d < 3; ++ d)
+            for (int i = 0; i < Width; ++ i) {
+                node.min[d][i] =   std::numeric_limits<float>::infinity();
+                node.max[d][i] = - std::numeric_limits<float>::infinity();
+            }
+        std::fill(node.child, node.child + Width, uint32_t(empty_slot));
+        return node;
+    }
+
+    template<typename CoordType>
+    void set_child(Node &node, int slot, const Tree<3, CoordType> &tree, size_t binary_idx)
+    {
+        const auto &bbox = tree.node(binary_idx).bbox;
+        for (int d = 0; d < 3; ++ d) {
+            node.min[d][slot] = float(bbox.min()(d)) - m_bbox_eps;
+            node.max[d][slot] = float(bbox.max()(d)) + m_bbox_eps;
+        }
+    }
+
+    // Collapse an inner node of the binary tree together with its descendants up to Width children into a single wide node.
+    template<typename CoordType>
+    uint32_t build_recursive(const Tree<3, CoordType> &tree, size_t binary_idx)
+    {
+        assert(tree.node(binary_idx).is_inner());
+        std::array<size_t, Width> children;
+        int                       num_children = 2;
+        children[0] = tree.left_child_idx(binary_idx);
+        children[1] = tree.right_child_idx(binary_idx);
+        // Open the inner child with the largest surface area until the wide node is full.
+        while (num_children < Width) {
+            int   best      = -1;
+            float best_area = -1.f;
+            for (int i = 0; i < num_children; ++ i)
+                if (const auto &child = tree.node(children[i]); child.is_inner()) {
+                    const auto  size = child.bbox.sizes();
+                    const float area = float(size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+                    if (area > best_area) {
+                        best      = i;
+                        best_area = area;
+                    }
+                }
+            if (best == -1)
+                break;
+            const size_t opened = children[best];
+            children[best]           = tree.left_child_idx(opened);
+            children[num_children ++] = tree.right_child_idx(opened);
+        }
+
+        const uint32_t node_idx = uint32_t(m_nodes.size());
+        m_nodes.emplace_back(empty_node());
+        for (int i = 0; i < num_children; ++ i) {
+            const auto &child = tree.node(children[i]);
+            assert(child.is_valid());
+            // m_nodes may be reallocated by the recursive call, don't keep a reference over it.
+            const uint32_t child_ref = child.is_leaf() ? (uint32_t(child.idx) | leaf_flag) : build_recursive(tree, children[i]);
+            set_child(m_nodes[node_idx], i, tree, children[i]);
+            m_nodes[node_idx].child[i] = child_ref;
+        }
+        return node_idx;
+    }
+
+    std::vector<Node> m_nodes;
+    float             m_bbox_eps { 0.f };
+};
+
+using WideTree4 = WideTree<4>;
+
+namespace detail {
+
+    // Maximum number of rays traversed together. Longer batches are split into packets of this size.
+    constexpr size_t RayPacketSize = 8;
+
+    // Single precision copy of a ray for the ray / box tests.
+    struct WideRay {
+        float origin[3];
+        float invdir[3];
+    };
+
+    template<typename VectorType>
+    inline WideRay make_wide_ray(const VectorType &origin, const VectorType &dir)
+    {
+        WideRay out;
+        for (int d = 0; d < 3; ++ d) {
+            out.origin[d] = float(origin(d));
+            // Avoid division by zero, which would produce NaNs for rays parallel to the bounding box planes.
+            const float dd = float(dir(d));
+            out.invdir[d] = 1.f / (std::abs(dd) < 1e-30f ? std::copysign(1e-30f, dd) : dd);
+        }
+        return out;
+    }
+
+    // Test a ray against all the bounding boxes of a wide node, returns a bit mask of the children hit before tmax.
+    // Also returns the entry distances of the ray into the bounding boxes for ordering the traversal.
+    // The near and far planes of the boxes are selected by the signs of the ray direction, thus the inverted boxes
+    // of the unused slots are never hit.
+    template<int Width>
+    inline uint32_t ray_wide_node_intersect(const typename WideTree<Width>::Node &node, const WideRay &ray, float tmax, float (&tnear)[Width])
+    {
+        const float *near_x = ray.invdir[0] < 0.f ? node.max[0] : node.min[0];
+        const float *far_x  = ray.invdir[0] < 0.f ? node.min[0] : node.max[0];
+        const float *near_y = ray.invdir[1] < 0.f ? node.max[1] : node.min[1];
+        const float *far_y  = ray.invdir[1] < 0.f ? node.min[1] : node.max[1];
+        const float *near_z = ray.invdir[2] < 0.f ? node.max[2] : node.min[2];
+        const float *far_z  = ray.invdir[2] < 0.f ? node.min[2] : node.max[2];
+#ifdef SLIC3R_AABB_WIDE_SSE2
+        if constexpr (Width == 4) {
+            // Single SSE register holds one coordinate of all the 4 children.
+            const __m128 tn = _mm_max_ps(
+                _mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_load_ps(near_x), _mm_set1_ps(ray.origin[0])), _mm_set1_ps(ray.invdir[0])),
+                           _mm_mul_ps(_mm_sub_ps(_mm_load_ps(near_y), _mm_set1_ps(ray.origin[1])), _mm_set1_ps(ray.invdir[1]))),
+                _mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_load_ps(near_z), _mm_set1_ps(ray.origin[2])), _mm_set1_ps(ray.invdir[2])),
+                           _mm_setzero_ps()));
+            const __m128 tf = _mm_min_ps(
+                _mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_load_ps(far_x), _mm_set1_ps(ray.origin[0])), _mm_set1_ps(ray.invdir[0])),
+                           _mm_mul_ps(_mm_sub_ps(_mm_load_ps(far_y), _mm_set1_ps(ray.origin[1])), _mm_set1_ps(ray.invdir[1]))),
+                _mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_load_ps(far_z), _mm_set1_ps(ray.origin[2])), _mm_set1_ps(ray.invdir[2])),
+                           _mm_set1_ps(tmax)));
+            _mm_storeu_ps(tnear, tn);
+            return uint32_t(_mm_movemask_ps(_mm_cmple_ps(tn, tf)));
+        }
+#endif // SLIC3R_AABB_WIDE_SSE2
+        bool hit[Width];
+        for (int i = 0; i < Width; ++ i) {
+            const float tn = std::max(std::max((near_x[i] - ray.origin[0]) * ray.invdir[0], (near_y[i] - ray.origin[1]) * ray.invdir[1]),
+                                      std::max((near_z[i] - ray.origin[2]) * ray.invdir[2], 0.f));
+            const float tf = std::min(std::min((far_x[i] - ray.origin[0]) * ray.invdir[0], (far_y[i] - ray.origin[1]) * ray.invdir[1]),
+                                      std::min((far_z[i] - ray.origin[2]) * ray.invdir[2], tmax));
+            tnear[i] = tn;
+            hit[i]   = tn <= tf;
+        }
+        uint32_t mask = 0;
+        for (int i = 0; i < Width; ++ i)
+            mask |= uint32_t(hit[i]) << i;
+        return mask;
+    }
+
+    // Traverse a packet of up to RayPacketSize rays, find the first hit of each ray.
+    // hits[i].id is set to -1 for rays not hitting any triangle.
+    template<typename VertexType, typename IndexedFaceType, int Width, typename VectorType>
+    inline void intersect_ray_packet_first_hit(
+        const std::vector<VertexType>      &vertices,
+        const std::vector<IndexedFaceType> &faces,
+        const WideTree<Width>              &tree,
+        const VectorType                   *origins,
+        const VectorType                   *dirs,
+        size_t                              num_rays,
+        igl::Hit                           *hits,
+        double                              eps)
+    {
+        assert(num_rays > 0 && num_rays <= RayPacketSize);
+        using Node = typename WideTree<Width>::Node;
+
+        WideRay rays[RayPacketSize];
+        // Distance to the closest hit found so far, in double precision for the triangle tests
+        // and rounded up to single precision for the box tests.
+        double  tmax[RayPacketSize];
+        float   tmaxf[RayPacketSize];
+        for (size_t r = 0; r < num_rays; ++ r) {
+            rays[r]    = make_wide_ray(origins[r], dirs[r]);
+            tmax[r]    = std::numeric_limits<double>::infinity();
+            tmaxf[r]   = std::numeric_limits<float>::infinity();
+            hits[r].id = -1;
+        }
+
+        // Stack of nodes to visit together with the mask of rays, which hit the node's bounding box.
+        struct StackEntry {
+            uint32_t node;
+            uint32_t ray_mask;
+        };
+        // Enough for a depth of 64 levels of a full tree.
+        StackEntry stack[64 * Width];
+        size_t     stack_size = 0;
+        stack[stack_size ++] = { 0, (uint32_t(1) << num_rays) - 1 };
+
+        while (stack_size > 0) {
+            const StackEntry entry = stack[-- stack_size];
+            const Node      &node  = tree.node(entry.node);
+            // Ray masks of the children hit and entry distances for ordering the traversal.
+            uint32_t child_rays[Width] = {};
+            float    child_tnear[Width];
+            bool     first = true;
+            for (size_t r = 0; r < num_rays; ++ r)
+                if (entry.ray_mask & (uint32_t(1) << r)) {
+                    float          tnear[Width];
+                    const uint32_t child_mask = ray_wide_node_intersect<Width>(node, rays[r], tmaxf[r], tnear);
+                    for (int i = 0; i < Width; ++ i)
+                        child_rays[i] |= ((child_mask >> i) & 1) << r;
+                    if (first) {
+                        // Order the children by the first active ray of the packet only, the rays are expected to be coherent.
+                        std::copy(tnear, tnear + Width, child_tnear);
+                        first = false;
+                    }
+                }
+            // Test the leaves, collect the inner nodes to be visited.
+            int order[Width];
+            int num_inner = 0;
+            for (int i = 0; i < Width; ++ i) {
+                if (child_rays[i] == 0)
+                    continue;
+                const uint32_t child = node.child[i];
+                if (WideTree<Width>::is_leaf(child)) {
+                    const uint32_t face_idx = WideTree<Width>::leaf_idx(child);
+                    const auto    &face     = faces[face_idx];
+                    for (size_t r = 0; r < num_rays; ++ r) {
+                        if ((child_rays[i] & (uint32_t(1) << r)) == 0)
+                            continue;
+                        double t, u, v;
+                        if (intersect_triangle(origins[r], dirs[r], vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps)
+                            && t > 0. && t < tmax[r]) {
+                            tmax[r]  = t;
+                            tmaxf[r] = std::nextafter(float(t), std::numeric_limits<float>::infinity());
+                            hits[r]  = igl::Hit{ int(face_idx), -1, float(u), float(v), float(t) };
+                        }
+                    }
+                } else
+                    order[num_inner ++] = i;
+            }
+            // Push the farthest child first, so that the closest child is visited first and it shortens the rays early.
+            for (int k = 1; k < num_inner; ++ k)
+                for (int j = k; j > 0 && child_tnear[order[j - 1]] < child_tnear[order[j]]; -- j)
+                    std::swap(order[j - 1], order[j]);
+            for (int k = 0; k < num_inner; ++ k) {
+                assert(stack_size < sizeof(stack) / sizeof(stack[0]));
+                stack[stack_size ++] = { node.child[order[k]], child_rays[order[k]] };
+            }
+        }
+    }
+
+} // namespace detail
+
+// Find a first intersection of a ray with indexed triangle set using a wide tree.
+// Intersection test is calculated with the accuracy of VectorType::Scalar,
+// while the ray / box tests are calculated in single precision.
+template<typename VertexType, typename IndexedFaceType, int Width, typename VectorType>
+inline bool intersect_ray_first_hit(
+    // Indexed triangle set - 3D vertices.
+    const std::vector<VertexType>      &vertices,
+    // Indexed triangle set - triangular faces, references to vertices.
+    const std::vector<IndexedFaceType> &faces,
+    // Wide tree collapsed from AABBTreeIndirect::Tree over vertices & faces.
+    const WideTree<Width>              &tree,
+    // Origin of the ray.
+    const VectorType                   &origin,
+    // Direction of the ray.
+    const VectorType                   &dir,
+    // First intersection of the ray with the indexed triangle set.
+    igl::Hit                           &hit,
+    // Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+    const double                        eps = 0.000001)
+{
+    if (tree.empty())
+        return false;
+    igl::Hit out;
+    detail::intersect_ray_packet_first_hit(vertices, faces, tree, &origin, &dir, 1, &out, eps);
+    if (out.id < 0)
+        return false;
+    hit = out;
+    return true;
+}
+
+// Find first intersections of a batch of rays with indexed triangle set using a wide tree.
+// The rays are traversed in packets, which pays off if the rays are coherent, for example if they share their origin.
+// hits are resized to the number of rays, hits[i].id is -1 if the i-th ray does not hit any triangle.
+// Returns the number of rays hitting the indexed triangle set.
+template<typename VertexType, typename IndexedFaceType, int Width, typename VectorType>
+inline size_t intersect_rays_first_hit(
+    // Indexed triangle set - 3D vertices.
+    const std::vector<VertexType>      &vertices,
+    // Indexed triangle set - triangular faces, references to vertices.
+    const std::vector<IndexedFaceType> &faces,
+    // Wide tree collapsed from AABBTreeIndirect::Tree over vertices & faces.
+    const WideTree<Width>              &tree,
+    // Origins of the rays.
+    const std::vector<VectorType>      &origins,
+    // Directions of the rays.
+    const std::vector<VectorType>      &dirs,
+    // First intersections of the rays with the indexed triangle set.
+    std::vector<igl::Hit>              &hits,
+    // Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+    const double                        eps = 0.000001)
+{
+    assert(origins.size() == dirs.size());
+    hits.assign(origins.size(), igl::Hit{ -1, -1, 0.f, 0.f, 0.f });
+    if (tree.empty())
+        return 0;
+    for (size_t i = 0; i < origins.size(); i += detail::RayPacketSize)
+        detail::intersect_ray_packet_first_hit(vertices, faces, tree, origins.data() + i, dirs.data() + i,
+            std::min(detail::RayPacketSize, origins.size() - i), hits.data() + i, eps);
+    return std::count_if(hits.begin(), hits.end(), [](const igl::Hit &hit) { return hit.id >= 0; });
+}
+
+} // namespace AABBTreeIndirect
+} // namespace Slic3r
+
+#endif // slic3r_AABBTreeWide_hpp_
@@ -0,0 +1,75 @@
+#include "CompressedPoints.hpp"
+
+#include <limits>
+
+#include "Exception.hpp"
+
+namespace Slic3r {
+
+void CompressedPaths::append(const Points &points)
+{
+    // The 32bit offsets limit the size of a single container to 4GB of compressed data.
+    if (m_data.size() > size_t(std::numeric_limits<uint32_t>::max()) || points.size() > size_t(std::numeric_limits<uint32_t>::max()))
+        throw Slic3r::RuntimeError("CompressedPaths: Too many points");
+    m_offsets.emplace_back(uint32_t(m_data.size()));
+    m_num_points.emplace_back(uint32_t(points.size()));
+    PointsCoding::write_points(m_data, points);
+}
+
+void CompressedPaths::decompress(size_t idx, Points &out) const
+{
+    assert(idx < this->size());
+    out.clear();
+    const uint8_t *begin = m_data.data() + m_offsets[idx];
+    const uint8_t *end   = m_data.data() + (idx + 1 < m_offsets.size() ? m_offsets[idx + 1] : m_data.size());
+    [[maybe_unused]] const uint8_t *ptr = PointsCoding::read_points(begin, end, m_num_points[idx], out);
+    assert(ptr == end);
+}
+
+Polygons CompressedPaths::polygons() const
+{
+    Polygons out(this->size());
+    for (size_t i = 0; i < out.size(); ++ i)
+        this->decompress(i, out[i].points);
+    return out;
+}
+
+Polylines CompressedPaths::polylines() const
+{
+    Polylines out(this->size());
+    for (size_t i = 0; i < out.size(); ++ i)
+        this->decompress(i, out[i].points);
+    return out;
+}
+
+void CompressedExPolygons::append(const ExPolygon &expolygon)
+{
+    m_contours.emplace_back(uint32_t(m_paths.size()));
+    m_paths.append(expolygon.contour.points);
+    for (const Polygon &hole : expolygon.holes)
+        m_paths.append(hole.points);
+}
+
+ExPolygon CompressedExPolygons::expolygon(size_t idx) const
+{
+    assert(idx < this->size());
+    const size_t first = m_contours[idx];
+    const size_t last  = idx + 1 < m_contours.size() ? m_contours[idx + 1] : m_paths.size();
+    ExPolygon out;
+    m_paths.decompress(first, out.contour.points);
+    out.holes.assign(last - first - 1, Polygon());
+    for (size_t i = first + 1; i < last; ++ i)
+        m_paths.decompress(i, out.holes[i - first - 1].points);
+    return out;
+}
+
+ExPolygons CompressedExPolygons::expolygons() const
+{
+    ExPolygons out;
+    out.reserve(this->size());
+    for (size_t i = 0; i < this->size(); ++ i)
+        out.emplace_back(this->expolygon(i));
+    return out;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,187 @@
+#ifndef slic3r_CompressedPoints_hpp_
+#define slic3r_CompressedPoints_hpp_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "ExPolygon.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "Polyline.hpp"
+
+namespace Slic3r {
+
+// Compact coding of points for data, which is kept, but rarely accessed:
+// Each point is predicted by extending the preceding segment, the differences between the predicted and the actual
+// coordinates are zig-zag encoded into variable length integers of 7 bits per byte. Tessellated curves, where
+// the neighbor segments are of similar length and direction, take around 4 bytes per point instead of sizeof(Point).
+namespace PointsCoding {
+
+inline uint64_t zigzag_encode(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+inline int64_t  zigzag_decode(uint64_t v) { return int64_t(v >> 1) ^ - int64_t(v & 1); }
+
+template<typename Buffer>
+inline void write_varint(Buffer &dst, uint64_t v)
+{
+    using value_type = typename Buffer::value_type;
+    for (; v >= 0x80; v >>= 7)
+        dst.push_back(value_type(v | 0x80));
+    dst.push_back(value_type(v));
+}
+
+// Returns pointer past the variable length integer read, nullptr if the data is truncated.
+inline const uint8_t* read_varint(const uint8_t *ptr, const uint8_t *end, uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && ptr != end; shift += 7) {
+        const uint8_t c = *ptr ++;
+        v |= uint64_t(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+            return ptr;
+    }
+    return nullptr;
+}
+
+// The number of points is not stored.
+template<typename Buffer>
+inline void write_points(Buffer &dst, const Points &pts)
+{
+    int64_t x = 0, y = 0, dx = 0, dy = 0;
+    for (const Point &pt : pts) {
+        const int64_t dx_new = int64_t(pt.x()) - x;
+        const int64_t dy_new = int64_t(pt.y()) - y;
+        write_varint(dst, zigzag_encode(dx_new - dx));
+        write_varint(dst, zigzag_encode(dy_new - dy));
+        x  = pt.x();
+        y  = pt.y();
+        dx = dx_new;
+        dy = dy_new;
+    }
+}
+
+// Appends num_points to dst. Returns pointer past the points read, nullptr if the data is truncated.
+inline const uint8_t* read_points(const uint8_t *ptr, const uint8_t *end, size_t num_points, Points &dst)
+{
+    dst.reserve(dst.size() + num_points);
+    int64_t x = 0, y = 0, dx = 0, dy = 0;
+    for (size_t i = 0; i < num_points; ++ i) {
+        uint64_t ex, ey;
+        if (ptr = read_varint(ptr, end, ex); ptr == nullptr || (ptr = read_varint(ptr, end, ey)) == nullptr)
+            return nullptr;
+        dx += zigzag_decode(ex);
+        dy += zigzag_decode(ey);
+        x  += dx;
+        y  += dy;
+        dst.emplace_back(coord_t(x), coord_t(y));
+    }
+    return ptr;
+}
+
+} // namespace PointsCoding
+
+// Paths (points of polygons or polylines) compressed by PointsCoding.
+// Each path is compressed separately, thus any path may be decompressed without decompressing the other paths.
+class CompressedPaths
+{
+public:
+    CompressedPaths() = default;
+    explicit CompressedPaths(const Polygons &polygons) { this->append(polygons); this->shrink_to_fit(); }
+    explicit CompressedPaths(const Polylines &polylines) { this->append(polylines); this->shrink_to_fit(); }
+
+    void    append(const Points &points);
+    void    append(const Polygons &polygons) { for (const Polygon &polygon : polygons) this->append(polygon.points); }
+    void    append(const Polylines &polylines) { for (const Polyline &polyline : polylines) this->append(polyline.points); }
+    void    clear() { m_data.clear(); m_offsets.clear(); m_num_points.clear(); }
+    void    shrink_to_fit() { m_data.shrink_to_fit(); m_offsets.shrink_to_fit(); m_num_points.shrink_to_fit(); }
+
+    bool    empty() const { return m_num_points.empty(); }
+    // Number of paths.
+    size_t  size() const { return m_num_points.size(); }
+    size_t  num_points(size_t idx) const { return m_num_points[idx]; }
+    // Decompress a single path into out, replacing its content.
+    void    decompress(size_t idx, Points &out) const;
+    Points  points(size_t idx) const { Points out; this->decompress(idx, out); return out; }
+
+    Polygons  polygons() const;
+    Polylines polylines() const;
+
+    // Memory allocated by this container.
+    size_t  memory_size() const
+        { return m_data.capacity() * sizeof(uint8_t) + (m_offsets.capacity() + m_num_points.capacity()) * sizeof(uint32_t); }
+
+    // Input iterator decompressing the paths one by one. The reference returned is valid until the iterator is advanced.
+    class const_iterator {
+    public:
+        using value_type        = Points;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Points*;
+        using reference         = const Points&;
+        using iterator_category = std::input_iterator_tag;
+
+        const_iterator(const CompressedPaths &paths, size_t idx) : m_paths(&paths), m_idx(idx) {}
+        const Points& operator*() const {
+            if (m_decompressed != m_idx) {
+                m_paths->decompress(m_idx, m_points);
+                m_decompressed = m_idx;
+            }
+            return m_points;
+        }
+        const Points* operator->() const { return &**this; }
+        bool operator==(const const_iterator &rhs) const { assert(m_paths == rhs.m_paths); return m_idx == rhs.m_idx; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        const_iterator& operator++() { ++ m_idx; return *this; }
+        const Points& operator++(int) { const Points &out = **this; ++ m_idx; return out; }
+
+    private:
+        const CompressedPaths  *m_paths;
+        size_t                  m_idx;
+        mutable size_t          m_decompressed { size_t(-1) };
+        mutable Points          m_points;
+    };
+
+    const_iterator cbegin() const { return const_iterator(*this, 0); }
+    const_iterator begin()  const { return this->cbegin(); }
+    const_iterator cend()   const { return const_iterator(*this, this->size()); }
+    const_iterator end()    const { return this->cend(); }
+
+private:
+    std::vector<uint8_t>    m_data;
+    // Start of each path in m_data.
+    std::vector<uint32_t>   m_offsets;
+    std::vector<uint32_t>   m_num_points;
+};
+
+// ExPolygons compressed by PointsCoding: contours followed by their holes stored as CompressedPaths.
+class CompressedExPolygons
+{
+public:
+    CompressedExPolygons() = default;
+    explicit CompressedExPolygons(const ExPolygons &expolygons) { this->append(expolygons); this->shrink_to_fit(); }
+
+    void    append(const ExPolygon &expolygon);
+    void    append(const ExPolygons &expolygons) { for (const ExPolygon &expolygon : expolygons) this->append(expolygon); }
+    void    clear() { m_paths.clear(); m_contours.clear(); }
+    void    shrink_to_fit() { m_paths.shrink_to_fit(); m_contours.shrink_to_fit(); }
+
+    bool    empty() const { return m_contours.empty(); }
+    // Number of ExPolygons.
+    size_t  size() const { return m_contours.size(); }
+    ExPolygon  expolygon(size_t idx) const;
+    ExPolygons expolygons() const;
+    // Contours and holes of all ExPolygons.
+    const CompressedPaths& paths() const { return m_paths; }
+
+    size_t  memory_size() const { return m_paths.memory_size() + m_contours.capacity() * sizeof(uint32_t); }
+
+private:
+    CompressedPaths         m_paths;
+    // Index of the contour of each ExPolygon in m_paths, the holes follow the contour.
+    std::vector<uint32_t>   m_contours;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_CompressedPoints_hpp_
@@ -40,6 +40,7 @@
 #include <set>
 #include <cstdlib>
 #include <cstring>
+#include <typeinfo>
 
 #include "format.hpp"
 #include "Utils.hpp"
@@ -390,8 +391,13 @@ std::string ConfigBase::SetDeserializeItem::format(std::initializer_list<double>
 
 void ConfigBase::apply_only(const ConfigBase &other, const t_config_option_keys &keys, bool ignore_nonexistent)
 {
+    // Applying one DynamicConfig to another, share the options instead of copying their values where possible.
+    DynamicConfig       *dynamic_this  = dynamic_cast<DynamicConfig*>(this);
+    const DynamicConfig *dynamic_other = dynamic_this ? dynamic_cast<const DynamicConfig*>(&other) : nullptr;
     // loop through options and apply them
     for (const t_config_option_key &opt_key : keys) {
+        if (dynamic_other != nullptr && dynamic_this->apply_shared(*dynamic_other, opt_key))
+            continue;
         // Create a new option with default value for the key.
         // If the key is not in the parameter definition, or this ConfigBase is a static type and it does not support the parameter,
         // an exception is thrown if not ignore_nonexistent.
@@ -1057,7 +1063,7 @@ void ConfigBase::null_nullables()
 DynamicConfig::DynamicConfig(const ConfigBase& rhs, const t_config_option_keys& keys)
 {
 	for (const t_config_option_key& opt_key : keys)
-		this->options[opt_key] = std::unique_ptr<ConfigOption>(rhs.option(opt_key)->clone());
+		this->options[opt_key].reset(rhs.option(opt_key)->clone());
 }
 
 bool DynamicConfig::operator==(const DynamicConfig &rhs) const
@@ -1067,7 +1073,7 @@ bool DynamicConfig::operator==(const DynamicConfig &rhs) const
     auto it2     = rhs.options.begin();
     auto it2_end = rhs.options.end();
     for (; it1 != it1_end && it2 != it2_end; ++ it1, ++ it2)
-		if (it1->first != it2->first || *it1->second != *it2->second)
+		if (it1->first != it2->first || (it1->second != it2->second && *it1->second != *it2->second))
 			// key or value differ
 			return false;
     return it1 == it1_end && it2 == it2_end;
@@ -1089,9 +1095,12 @@ size_t DynamicConfig::remove_nil_options()
 ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool create)
 {
     auto it = options.find(opt_key);
-    if (it != options.end())
-        // Option was found.
+    if (it != options.end()) {
+        // Option was found. Detach it from the other DynamicConfigs before it gets modified.
+        if (it->second.use_count() > 1)
+            it->second.reset(it->second->clone());
         return it->second.get();
+    }
     if (! create)
         // Option was not found and a new option shall not be created.
         return nullptr;
@@ -1105,7 +1114,7 @@ ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool cre
         // Let the parent decide what to do if the opt_key is not defined by this->def().
         return nullptr;
     ConfigOption *opt = optdef->create_default_option();
-    this->options.emplace_hint(it, opt_key, std::unique_ptr<ConfigOption>(opt));
+    this->options.emplace_hint(it, opt_key, std::shared_ptr<ConfigOption>(opt));
     return opt;
 }
 
@@ -1115,6 +1124,31 @@ const ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key) co
     return (it == options.end()) ? nullptr : it->second.get();
 }
 
+bool DynamicConfig::apply_shared(const DynamicConfig &other, const t_config_option_key &opt_key)
+{
+    auto it_other = other.options.find(opt_key);
+    if (it_other == other.options.end())
+        return false;
+    auto it = this->options.lower_bound(opt_key);
+    if (it == this->options.end() || it->first != opt_key) {
+        // Create a new ConfigOption the same way as optptr() does.
+        const ConfigDef       *def    = this->def();
+        const ConfigOptionDef *optdef = def ? def->get(opt_key) : nullptr;
+        if (optdef == nullptr)
+            return false;
+        it = this->options.emplace_hint(it, opt_key, std::shared_ptr<ConfigOption>(optdef->create_default_option()));
+    }
+    if (typeid(*it->second) == typeid(*it_other->second))
+        // Only share an option of the same class, so that for example a nullable option stays nullable.
+        it->second = it_other->second;
+    else {
+        if (it->second.use_count() > 1)
+            it->second.reset(it->second->clone());
+        it->second->set(it_other->second.get());
+    }
+    return true;
+}
+
 t_config_option_keys DynamicConfig::keys() const
 {
     t_config_option_keys keys;
@@ -1153,8 +1187,8 @@ t_config_option_keys StaticConfig::keys() const
 template<typename Fn>
 static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const DynamicConfig &rhs, Fn fn)
 {
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator i = lhs.cbegin();
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator j = rhs.cbegin();
+    DynamicConfig::options_map::const_iterator i = lhs.cbegin();
+    DynamicConfig::options_map::const_iterator j = rhs.cbegin();
     while (i != lhs.cend() && j != rhs.cend())
         if (i->first < j->first)
             ++ i;
@@ -1176,7 +1210,7 @@ static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const Dynami
 bool DynamicConfig::equals(const DynamicConfig &other) const
 { 
     return ! dynamic_config_iterate(*this, other, 
-        [](const t_config_option_key & /* key */, const ConfigOption *l, const ConfigOption *r) { return *l != *r; });
+        [](const t_config_option_key & /* key */, const ConfigOption *l, const ConfigOption *r) { return l != r && *l != *r; });
 }
 
 // Returns options differing in the two configs, ignoring options not present in both configs.
@@ -1185,7 +1219,8 @@ t_config_option_keys DynamicConfig::diff(const DynamicConfig &other) const
     t_config_option_keys diff;
     dynamic_config_iterate(*this, other, 
         [&diff](const t_config_option_key &key, const ConfigOption *l, const ConfigOption *r) {
-            if (*l != *r)
+            // Options shared by the two configs are equal.
+            if (l != r && *l != *r)
                 diff.emplace_back(key);
             // Continue iterating.
             return false; 
@@ -1199,7 +1234,7 @@ t_config_option_keys DynamicConfig::equal(const DynamicConfig &other) const
     t_config_option_keys equal;
     dynamic_config_iterate(*this, other, 
         [&equal](const t_config_option_key &key, const ConfigOption *l, const ConfigOption *r) {
-            if (*l == *r)
+            if (l == r || *l == *r)
                 equal.emplace_back(key);
             // Continue iterating.
             return false;
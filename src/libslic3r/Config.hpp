@@ -45,6 +45,7 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <typeinfo>
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -2332,8 +2333,24 @@ public:
 		    case coPoint3:          archive(*static_cast<const ConfigOptionPoint3*>(opt)); 			break;
 		    case coBool:            archive(*static_cast<const ConfigOptionBool*>(opt)); 			break;
 		    case coBools:           archive(*static_cast<const ConfigOptionBools*>(opt)); 			break;
-		    case coEnum:            archive(*static_cast<const ConfigOptionEnumGeneric*>(opt)); 	break;
-		    case coEnums:           archive(*static_cast<const ConfigOptionEnumsGeneric*>(opt)); 	break;
+		    // The typed enums (ConfigOptionEnum<T> cloned from a StaticPrintConfig) may have an underlying type narrower
+		    // than int, they are stored as the generic enums loaded by load_option_from_archive().
+		    case coEnum:
+		        if (auto *generic = dynamic_cast<const ConfigOptionEnumGeneric*>(opt); generic)
+		            archive(*generic);
+		        else {
+		            ConfigOptionEnumGeneric generic_opt(this->enum_def->m_enum_keys_map, opt->getInt());
+		            archive(generic_opt);
+		        }
+		        break;
+		    case coEnums:
+		        if (auto *generic = dynamic_cast<const ConfigOptionEnumsGeneric*>(opt); generic)
+		            archive(*generic);
+		        else {
+		            ConfigOptionEnumsGeneric generic_opt(this->enum_def->m_enum_keys_map, opt->getInts());
+		            archive(generic_opt);
+		        }
+		        break;
 		    default:                throw ConfigurationError(std::string("ConfigOptionDef::save_option_to_archive(): Unknown option type for option ") + this->opt_key);
 		    }
 		}
@@ -2766,6 +2783,10 @@ private:
 
 // Configuration store with dynamic number of configuration values.
 // In Slic3r, the dynamic config is mostly used at the user interface layer.
+// The option values are shared between copies of a DynamicConfig (copy on write): Copying a DynamicConfig
+// or applying one DynamicConfig to another does not clone the options, an option is cloned only when
+// it is accessed for modification through the non-const optptr(). Therefore a pointer to a modifiable
+// option must not be held over a copy of its DynamicConfig.
 class DynamicConfig : public virtual ConfigBase
 {
 public:
@@ -2776,14 +2797,12 @@ public:
 	explicit DynamicConfig(const ConfigBase& rhs) : DynamicConfig(rhs, rhs.keys()) {}
 	virtual ~DynamicConfig() override = default;
 
-    // Copy a content of one DynamicConfig to another DynamicConfig.
+    // Copy a content of one DynamicConfig to another DynamicConfig, sharing the options.
     // If rhs.def() is not null, then it has to be equal to this->def(). 
     DynamicConfig& operator=(const DynamicConfig &rhs) 
     {
         assert(this->def() == nullptr || this->def() == rhs.def());
-        this->clear();
-        for (const auto &kvp : rhs.options)
-            this->options[kvp.first].reset(kvp.second->clone());
+        this->options = rhs.options;
         return *this;
     }
 
@@ -2806,13 +2825,17 @@ public:
         for (const auto &kvp : rhs.options) {
             auto it = this->options.find(kvp.first);
             if (it == this->options.end())
-                this->options[kvp.first].reset(kvp.second->clone());
+                this->options.emplace(kvp.first, kvp.second);
             else {
                 assert(it->second->type() == kvp.second->type());
-                if (it->second->type() == kvp.second->type())
-                    *it->second = *kvp.second;
-                else
-                    it->second.reset(kvp.second->clone());
+                if (it->second->type() != kvp.second->type() || typeid(*it->second) == typeid(*kvp.second))
+                    // Only share an option of the same class, so that for example a nullable option stays nullable.
+                    it->second = kvp.second;
+                else {
+                    if (it->second.use_count() > 1)
+                        it->second.reset(it->second->clone());
+                    it->second->set(kvp.second.get());
+                }
             }
         }
         return *this;
@@ -2867,7 +2890,11 @@ public:
     // Overrides ConfigResolver::optptr().
     const ConfigOption*     optptr(const t_config_option_key &opt_key) const override;
     // Overrides ConfigBase::optptr(). Find ando/or create a ConfigOption instance for a given name.
+    // An option shared with another DynamicConfig is cloned first, as the caller may modify it.
     ConfigOption*           optptr(const t_config_option_key &opt_key, bool create = false) override;
+    // Set an option from other, creating it if needed. The option of other is shared instead of copying its value
+    // if it is of the same class. Returns false if other does not hold the option or this->def() does not define it.
+    bool                    apply_shared(const DynamicConfig &other, const t_config_option_key &opt_key);
     // Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store.
     t_config_option_keys    keys() const override;
     bool                    empty() const { return options.empty(); }
@@ -2894,12 +2921,13 @@ public:
     // Returns options being equal in the two configs, ignoring options not present in both configs.
     t_config_option_keys equal(const DynamicConfig &other) const;
 
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cbegin() const { return options.cbegin(); }
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cend()   const { return options.cend(); }
-    size_t                        												 size()   const { return options.size(); }
+    using                   options_map = std::map<t_config_option_key, std::shared_ptr<ConfigOption>>;
+    options_map::const_iterator cbegin() const { return options.cbegin(); }
+    options_map::const_iterator cend()   const { return options.cend(); }
+    size_t                      size()   const { return options.size(); }
 
 private:
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>> options;
+    options_map             options;
 
 	friend class cereal::access;
 	template<class Archive> void serialize(Archive &ar) { ar(options); }
@@ -19,6 +19,9 @@
 #include <vector>
 #include <cassert>
 #include <cstddef>
+#include <new>
+
+#include <oneapi/tbb/scalable_allocator.h>
 
 #include "libslic3r.h"
 #include "ExtrusionRole.hpp"
@@ -72,6 +75,15 @@ public:
     virtual Polylines as_polylines() const { Polylines dst; this->collect_polylines(dst); return dst; }
     virtual double length() const = 0;
     virtual double total_volume() const = 0;
+
+    // Extrusion entities are allocated and released by millions from the worker threads, one by one.
+    // Allocate them by the thread caching tbbmalloc the same way as their Points.
+    static void* operator new(size_t size) {
+        if (void *ptr = scalable_malloc(size); ptr != nullptr)
+            return ptr;
+        throw std::bad_alloc();
+    }
+    static void  operator delete(void *ptr) { scalable_free(ptr); }
 };
 
 using ExtrusionEntitiesPtr = std::vector<ExtrusionEntity*>;
@@ -1433,6 +1433,8 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
     // From now to the end of G-code, the G-code find / replace post-processor will be disabled.
     // Thus the PrusaSlicer generated config will NOT be processed by the G-code post-processor, see GH issue #7952.
     file.find_replace_supress();
+    // No moves are emitted past this point, the post-processor may only rewrite the footer.
+    m_processor.mark_footer_start();
 
     // adds tags for time estimators
     if (print.config().remaining_times.value)
@@ -1564,6 +1566,10 @@ void GCodeGenerator::process_layers(
                 if (m_wipe_tower && layer_tools.has_wipe_tower)
                     m_wipe_tower->next_layer();
                 print.throw_if_canceled();
+                // Layers written out to keep the memory budget are read back for the time they are being processed.
+                LayerSpillPageIn page_in(print.layer_spill());
+                for (const ObjectLayerToPrint &l : layer.second)
+                    page_in.add(l.object_layer);
                 return this->process_layer(print, layer.second, layer_tools, 
                     GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
                     &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
@@ -1589,7 +1595,9 @@ void GCodeGenerator::process_layers(
 
              return cooling_buffer->process_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
         });
-    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+    // GCodeFindReplace keeps no state between layers, thus the layers are processed in parallel.
+    // The serial output filter writes them in order.
+    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::parallel,
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
             return find_replace->process_layer(std::move(s));
         });
@@ -1658,6 +1666,12 @@ void GCodeGenerator::process_layers(
             } else {
                 ObjectLayerToPrint &layer = layers_to_print[layer_to_print_idx];
                 print.throw_if_canceled();
+                // Avoid crossing perimeters reads the layers of all objects at this print_z, see get_perimeter_spacing_external().
+                LayerSpillPageIn page_in(print.layer_spill());
+                page_in.add(layer.object_layer);
+                for (const PrintObject *object : print.objects())
+                    if (const Layer *object_layer = object->get_layer_at_printz(layer.print_z(), EPSILON); object_layer != layer.object_layer)
+                        page_in.add(object_layer);
                 return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), 
                     GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
                     &layer == &layers_to_print.back(), nullptr, single_object_idx);
@@ -1682,7 +1696,9 @@ void GCodeGenerator::process_layers(
                 return in.gcode;
             return cooling_buffer->process_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
         });
-    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+    // GCodeFindReplace keeps no state between layers, thus the layers are processed in parallel.
+    // The serial output filter writes them in order.
+    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::parallel,
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
             return find_replace->process_layer(std::move(s));
         });
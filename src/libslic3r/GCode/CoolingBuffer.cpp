@@ -99,7 +99,7 @@ struct CoolingLine
     };
 
     CoolingLine(unsigned int type, size_t  line_start, size_t  line_end) :
-        type(type), line_start(line_start), line_end(line_end),
+        type(type), line_start(line_start), line_end(line_end), comment_start(line_end), feedrate_start(0), feedrate_set(0),
         length(0.f), feedrate(0.f), time(0.f), time_max(0.f), slowdown(false) {}
 
     bool adjustable(bool slowdown_external_perimeters) const {
@@ -117,6 +117,13 @@ struct CoolingLine
     size_t  line_start;
     // End of this line at the G-code snippet.
     size_t  line_end;
+    // Start of the comment of this line at the G-code snippet, line_end if there is no comment.
+    size_t  comment_start;
+    // Start of the value of the F word at the G-code snippet, valid if TYPE_HAS_F is set.
+    // Remembered by parse_layer_gcode(), so that apply_layer_cooldown() does not need to search and parse the line again.
+    size_t  feedrate_start;
+    // Feedrate set by the F word in mm/min as written in the G-code, valid if TYPE_HAS_F is set.
+    int     feedrate_set;
     // XY Euclidian length of this segment.
     float   length;
     // Current feedrate, possibly adjusted.
@@ -396,6 +403,11 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
         if (*line_end == '\n')
             ++ line_end;
         CoolingLine line(0, line_start - gcode.c_str(), line_end - gcode.c_str());
+        // All the tags searched for below are G-code comments.
+        const size_t comment_pos = sline.find(';');
+        if (comment_pos != std::string_view::npos)
+            line.comment_start = line.line_start + comment_pos;
+        const std::string_view comment = sline.substr(std::min(comment_pos, sline.size()));
         if (boost::starts_with(sline, "G0 "))
             line.type = CoolingLine::TYPE_G0;
         else if (boost::starts_with(sline, "G1 "))
@@ -429,11 +441,14 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                     //auto [pend, ec] = 
                         fast_float::from_chars(&*(++ c), sline.data() + sline.size(), new_pos[axis]);
                     if (axis == AxisIdx::F) {
-                        // Convert mm/min to mm/sec.
-                        new_pos[AxisIdx::F] /= 60.f;
-                        if ((line.type & CoolingLine::TYPE_G92) == 0)
+                        if ((line.type & CoolingLine::TYPE_G92) == 0) {
                             // This is G0 or G1 line and it sets the feedrate. This mark is used for reducing the duplicate F calls.
                             line.type |= CoolingLine::TYPE_HAS_F;
+                            line.feedrate_start = line.line_start + (&*c - sline.data());
+                            line.feedrate_set   = int(new_pos[AxisIdx::F]);
+                        }
+                        // Convert mm/min to mm/sec.
+                        new_pos[AxisIdx::F] /= 60.f;
                     } else if (axis >= AxisIdx::I && axis <= AxisIdx::J)
                         line.type |= CoolingLine::TYPE_G2G3_IJ;
                     else if (axis == AxisIdx::R)
@@ -447,13 +462,13 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 (line.type & (CoolingLine::TYPE_G2G3_IJ | CoolingLine::TYPE_G2G3_R)));
             // Arc is defined either by IJ or by R, not by both.
             assert(! ((line.type & CoolingLine::TYPE_G2G3_IJ) && (line.type & CoolingLine::TYPE_G2G3_R)));
-            bool external_perimeter = boost::contains(sline, ";_EXTERNAL_PERIMETER");
-            bool wipe               = boost::contains(sline, ";_WIPE");
+            bool external_perimeter = boost::contains(comment, ";_EXTERNAL_PERIMETER");
+            bool wipe               = boost::contains(comment, ";_WIPE");
             if (external_perimeter)
                 line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
             if (wipe)
                 line.type |= CoolingLine::TYPE_WIPE;
-            if (boost::contains(sline, ";_EXTRUDE_SET_SPEED") && ! wipe) {
+            if (boost::contains(comment, ";_EXTRUDE_SET_SPEED") && ! wipe) {
                 line.type |= CoolingLine::TYPE_ADJUSTABLE;
                 active_speed_modifier = adjustment->lines.size();
             }
@@ -581,7 +596,7 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
             }
 
             line.time_max = line.time;
-        } else if (boost::contains(sline, ";_SET_FAN_SPEED")) {
+        } else if (boost::contains(comment, ";_SET_FAN_SPEED")) {
             auto speed_start = sline.find_last_of('D');
             int  speed       = 0;
             for (char num : sline.substr(speed_start + 1)) {
@@ -590,7 +605,7 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
 
             line.fan_speed = speed;
             line.type |= CoolingLine::TYPE_SET_FAN_SPEED;
-        } else if (boost::contains(sline, ";_RESET_FAN_SPEED")) {
+        } else if (boost::contains(comment, ";_RESET_FAN_SPEED")) {
             line.type |= CoolingLine::TYPE_RESET_FAN_SPEED;
         }
 
@@ -925,23 +940,18 @@ std::string CoolingBuffer::apply_layer_cooldown(
                 new_gcode += GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, m_fan_speed);
         } else if (line->type & CoolingLine::TYPE_EXTRUDE_END) {
             // Just remove this comment.
-        } else if (line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_ADJUSTABLE_EMPTY | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE | CoolingLine::TYPE_HAS_F)) {
-            // Find the start of a comment, or roll to the end of line.
-            const char *end = line_start;
-            for (; end < line_end && *end != ';'; ++ end);
-            // Find the 'F' word.
-            const char *fpos            = strstr(line_start + 2, " F") + 2;
-            int         new_feedrate    = current_feedrate;
+        } else if (line->type & CoolingLine::TYPE_HAS_F) {
+            // The cooling markers (TYPE_ADJUSTABLE, TYPE_ADJUSTABLE_EMPTY, TYPE_EXTERNAL_PERIMETER, TYPE_WIPE)
+            // are only emitted together with the F word, see GCodeWriter::set_speed().
+            // Start of a comment, or the end of line.
+            const char *end             = gcode.c_str() + line->comment_start;
+            // The 'F' word, both its position and value were recorded by parse_layer_gcode().
+            const char *fpos            = gcode.c_str() + line->feedrate_start;
+            int         new_feedrate    = line->slowdown ? int(floor(60. * line->feedrate + 0.5)) : line->feedrate_set;
             // Modify the F word of the current G-code line.
             bool        modify          = false;
             // Remove the F word from the current G-code line.
             bool        remove          = false;
-            assert(fpos != nullptr);
-            if (line->slowdown)
-                new_feedrate = int(floor(60. * line->feedrate + 0.5));
-            else
-                //auto res = 
-                    std::from_chars(fpos, line_end, new_feedrate);
             if (new_feedrate == current_feedrate) {
                 // No need to change the F value.
                 if ((line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_ADJUSTABLE_EMPTY | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE)) || line->length == 0.)
@@ -13,6 +13,8 @@
 #include <tuple>
 #include <utility>
 #include <cstring>
+#include <algorithm>
+#include <cassert>
 
 #include "../Utils.hpp"
 #include "libslic3r/Exception.hpp"
@@ -35,6 +37,27 @@ const void unescape_extended_search_mode(std::string &s)
 // \u: The hexadecimal representation of a two-byte character, made of 4 digits in the 0-9, A-F/a-f range.
 }
 
+// Is a non-empty proper suffix of "first" a proper prefix of "second"?
+static bool suffix_prefix_overlap(const std::string &first, const std::string &second)
+{
+    for (size_t len = 1; len < first.size() && len < second.size(); ++ len)
+        if (first.compare(first.size() - len, len, second, 0, len) == 0)
+            return true;
+    return false;
+}
+
+// Replacing all the occurrences of prev_pattern by prev_format, then all the occurrences of next_pattern
+// gives the same result as replacing both patterns in a single left to right pass, if the occurrences of the two
+// patterns never overlap and if the replacement of prev_pattern never creates a new occurrence of next_pattern.
+static bool can_apply_at_once(const std::string &prev_pattern, const std::string &prev_format, const std::string &next_pattern)
+{
+    auto cannot_overlap = [](const std::string &a, const std::string &b) {
+        return a.find(b) == std::string::npos && b.find(a) == std::string::npos && 
+               ! suffix_prefix_overlap(a, b) && ! suffix_prefix_overlap(b, a);
+    };
+    return cannot_overlap(prev_pattern, next_pattern) && cannot_overlap(prev_format, next_pattern);
+}
+
 GCodeFindReplace::GCodeFindReplace(const std::vector<std::string> &gcode_substitutions)
 {
     if ((gcode_substitutions.size() % 4) != 0)
@@ -66,6 +89,96 @@ GCodeFindReplace::GCodeFindReplace(const std::vector<std::string> &gcode_substit
         }
         m_substitutions.emplace_back(std::move(out));
     }
+
+    // Group runs of consecutive plain text substitutions, which could be applied in a single pass.
+    // Only the case sensitive substitutions, which do not match whole words only, are grouped.
+    std::vector<const Substitution*> group;
+    auto flush_group = [this, &group]() {
+        if (group.size() > 1) {
+            m_replacers.emplace_back(group);
+            m_steps.push_back({ size_t(group.front() - m_substitutions.data()), int(m_replacers.size()) - 1 });
+        } else if (group.size() == 1)
+            m_steps.push_back({ size_t(group.front() - m_substitutions.data()) });
+        group.clear();
+    };
+    for (const Substitution &substitution : m_substitutions) {
+        if (substitution.regexp || substitution.case_insensitive || substitution.whole_word || substitution.plain_pattern.empty()) {
+            flush_group();
+            m_steps.push_back({ size_t(&substitution - m_substitutions.data()) });
+        } else {
+            if (! std::all_of(group.begin(), group.end(), [&substitution](const Substitution *prev) {
+                    return can_apply_at_once(prev->plain_pattern, prev->format, substitution.plain_pattern); }))
+                flush_group();
+            group.emplace_back(&substitution);
+        }
+    }
+    flush_group();
+}
+
+GCodeFindReplace::MultiPatternReplacer::MultiPatternReplacer(const std::vector<const Substitution*> &substitutions)
+{
+    // Build a trie of the patterns. Zero transition means a missing child, no transition leads back to the root.
+    m_transitions.assign(256, 0);
+    m_state_match.assign(1, -1);
+    for (const Substitution *substitution : substitutions) {
+        uint32_t state = 0;
+        for (const char c : substitution->plain_pattern) {
+            const size_t idx = size_t(state) * 256 + uint8_t(c);
+            if (m_transitions[idx] == 0) {
+                m_transitions[idx] = uint32_t(m_state_match.size());
+                m_transitions.resize(m_transitions.size() + 256, 0);
+                m_state_match.emplace_back(-1);
+            }
+            state = m_transitions[idx];
+        }
+        assert(m_state_match[state] == -1);
+        m_state_match[state] = int(m_pattern_lengths.size());
+        m_pattern_lengths.emplace_back(substitution->plain_pattern.size());
+        m_replacements.emplace_back(substitution->format);
+    }
+
+    // Complete the transition table through the failure links, visiting the states in a breadth first order,
+    // thus the failure state of each state has been completed already.
+    // No pattern is a substring of another pattern (see can_apply_at_once()), thus a match is only reported
+    // by the state of the complete pattern and not by any of its suffixes.
+    std::vector<uint32_t> failure(m_state_match.size(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(m_state_match.size());
+    for (size_t c = 0; c < 256; ++ c)
+        if (uint32_t child = m_transitions[c]; child != 0)
+            queue.emplace_back(child);
+    for (size_t i = 0; i < queue.size(); ++ i) {
+        const uint32_t state = queue[i];
+        for (size_t c = 0; c < 256; ++ c) {
+            uint32_t &next = m_transitions[size_t(state) * 256 + c];
+            const uint32_t fallback = m_transitions[size_t(failure[state]) * 256 + c];
+            if (next == 0)
+                next = fallback;
+            else {
+                failure[next] = fallback;
+                queue.emplace_back(next);
+            }
+        }
+    }
+}
+
+void GCodeFindReplace::MultiPatternReplacer::replace_all(const std::string &in, std::string &out) const
+{
+    out.reserve(out.size() + in.size());
+    uint32_t state = 0;
+    size_t   copied = 0;
+    for (size_t i = 0; i < in.size(); ++ i) {
+        state = m_transitions[size_t(state) * 256 + uint8_t(in[i])];
+        if (const int pattern_idx = m_state_match[state]; pattern_idx != -1) {
+            // The patterns do not overlap, thus the first match to end is the leftmost one. Continue after the match.
+            const size_t start = i + 1 - m_pattern_lengths[pattern_idx];
+            out.append(in, copied, start - copied);
+            out.append(m_replacements[pattern_idx]);
+            copied = i + 1;
+            state  = 0;
+        }
+    }
+    out.append(in, copied, std::string::npos);
 }
 
 class ToStringIterator 
@@ -118,15 +231,20 @@ static void find_and_replace_whole_word(std::string &inout, const std::string &m
     }
 }
 
-std::string GCodeFindReplace::process_layer(const std::string &ain)
+std::string GCodeFindReplace::process_layer(const std::string &ain) const
 {
     std::string out;
     const std::string *in = &ain;
     std::string temp;
     temp.reserve(in->size());
 
-    for (const Substitution &substitution : m_substitutions) {
-        if (substitution.regexp) {
+    for (const Step &step : m_steps) {
+        const Substitution &substitution = m_substitutions[step.substitution_idx];
+        if (step.replacer_idx != -1) {
+            temp.clear();
+            m_replacers[step.replacer_idx].replace_all(*in, temp);
+            std::swap(out, temp);
+        } else if (substitution.regexp) {
             temp.clear();
             temp.reserve(in->size());
             boost::regex_replace(ToStringIterator(temp), in->begin(), in->end(),
@@ -9,6 +9,7 @@
 #include <boost/regex/v5/regex.hpp>
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include "../PrintConfig.hpp"
 
@@ -20,7 +21,8 @@ public:
     GCodeFindReplace(const std::vector<std::string> &gcode_substitutions);
 
 
-    std::string process_layer(const std::string &gcode);
+    // Thread safe, the layers may be processed in parallel.
+    std::string process_layer(const std::string &gcode) const;
     
 private:
     struct Substitution {
@@ -35,6 +37,33 @@ private:
         bool            single_line { false };
     };
     std::vector<Substitution> m_substitutions;
+
+    // Aho-Corasick automaton replacing the patterns of a group of plain text substitutions in a single pass.
+    class MultiPatternReplacer {
+    public:
+        MultiPatternReplacer(const std::vector<const Substitution*> &substitutions);
+        // Replace the leftmost non-overlapping occurrences of all the patterns, append the result to out.
+        void replace_all(const std::string &in, std::string &out) const;
+
+    private:
+        // Complete transition table of the automaton, 256 entries per state, state 0 is the root.
+        std::vector<uint32_t>    m_transitions;
+        // Index of the pattern matched when entering a state, -1 if none.
+        std::vector<int>         m_state_match;
+        std::vector<size_t>      m_pattern_lengths;
+        std::vector<std::string> m_replacements;
+    };
+
+    // The substitutions are applied in order. Each step applies either a single substitution,
+    // or a run of consecutive plain text substitutions at once, if they cannot influence each other.
+    struct Step {
+        // Index into m_substitutions.
+        size_t          substitution_idx;
+        // Index into m_replacers, -1 if the substitution is applied alone.
+        int             replacer_idx { -1 };
+    };
+    std::vector<Step>                 m_steps;
+    std::vector<MultiPatternReplacer> m_replacers;
 };
 
 }
@@ -11,6 +11,7 @@
 #include "libslic3r/GCode/GCodeWriter.hpp"
 #include "libslic3r/I18N.hpp"
 #include "libslic3r/Geometry/ArcWelder.hpp"
+#include "libslic3r/Thread.hpp"
 #include "GCodeProcessor.hpp"
 
 #include <boost/algorithm/string/case_conv.hpp>
@@ -20,6 +21,7 @@
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <float.h>
 #include <assert.h>
@@ -30,6 +32,10 @@
 #endif
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 
 static const float DEFAULT_TOOLPATH_WIDTH = 0.4f;
 static const float DEFAULT_TOOLPATH_HEIGHT = 0.2f;
@@ -48,6 +54,16 @@ static const Slic3r::Vec3f DEFAULT_EXTRUDER_OFFSET = Slic3r::Vec3f::Zero();
 // taken from PrusaResearch.ini - [printer:Original Prusa i3 MK2.5 MMU2]
 static const std::vector<std::string> DEFAULT_EXTRUDER_COLORS = { "#FF8000", "#DB5182", "#3EC0FF", "#FF4F4F", "#FBEB7D" };
 
+// fseek() taking a 64 bit offset, long is only 32 bit wide on Windows.
+static int fseek_64(FILE* f, size_t offset)
+{
+#ifdef _WIN32
+    return ::_fseeki64(f, __int64(offset), SEEK_SET);
+#else
+    return ::fseeko(f, off_t(offset), SEEK_SET);
+#endif // _WIN32
+}
+
 namespace Slic3r {
 
 const std::vector<std::string> GCodeProcessor::Reserved_Tags = {
@@ -1355,10 +1371,16 @@ void GCodeProcessor::initialize(const std::string& filename)
     // process gcode
     m_result.filename = filename;
     m_result.id = ++s_result_id;
+    m_exported_gcode.reset();
 }
 
 void GCodeProcessor::process_buffer(const std::string &buffer)
 {
+    // Keep track of the layout of the exported file, so that post_process() does not need to re-read it.
+    if (this->can_post_process_footer_only()) {
+        update_lines_ends_and_out_file_pos(buffer, m_exported_gcode.lines_ends, &m_exported_gcode.size);
+        m_exported_gcode.has_cr |= buffer.find('\r') != std::string::npos;
+    }
     //FIXME maybe cache GCodeLine gline to be over multiple parse_buffer() invocations.
     m_parser.parse_buffer(buffer, [this](GCodeReader&, const GCodeReader::GCodeLine& line) { 
         this->process_gcode_line(line, false);
@@ -3700,16 +3722,31 @@ void GCodeProcessor::process_T(const std::string_view command)
     }
 }
 
+bool GCodeProcessor::can_post_process_footer_only() const
+{
+    // Neither M73 nor M104 lines are inserted into the body of the G-code and the G-code is not converted to binary.
+    return !m_binarizer.is_enabled() && !m_time_processor.export_remaining_time_enabled && !m_result.backtrace_enabled;
+}
+
 void GCodeProcessor::post_process()
 {
     FilePtr in{ boost::nowide::fopen(m_result.filename.c_str(), "rb") };
     if (in.f == nullptr)
         throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for reading.\n"));
 
+    // Only the placeholders in the footer need to be updated, the body of the G-code is kept in place.
+    // The footer needs to start at the beginning of a line and no move may be stored past it.
+    const bool post_process_footer_only = this->can_post_process_footer_only() && m_exported_gcode.footer_start.has_value() &&
+        !m_exported_gcode.has_cr && (*m_exported_gcode.footer_start == 0 ||
+            (!m_exported_gcode.lines_ends.empty() &&
+             std::binary_search(m_exported_gcode.lines_ends.begin(), m_exported_gcode.lines_ends.end(), *m_exported_gcode.footer_start))) &&
+        (m_result.moves.empty() || m_result.moves.back().gcode_id <= size_t(std::upper_bound(m_exported_gcode.lines_ends.begin(),
+            m_exported_gcode.lines_ends.end(), *m_exported_gcode.footer_start) - m_exported_gcode.lines_ends.begin()));
+
     // temporary file to contain modified gcode
     std::string out_path = m_result.filename + ".postprocess";
-    FilePtr out{ boost::nowide::fopen(out_path.c_str(), "wb") };
-    if (out.f == nullptr)
+    FilePtr out{ post_process_footer_only ? nullptr : boost::nowide::fopen(out_path.c_str(), "wb") };
+    if (!post_process_footer_only && out.f == nullptr)
         throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for writing.\n"));
 
     std::vector<double> filament_mm(m_result.extruders_count, 0.0);
@@ -3824,6 +3861,129 @@ void GCodeProcessor::post_process()
         last_exported_stop[i] = time_in_minutes(m_time_processor.machines[i].time);
     }
 
+    // Helper class feeding the binarizer from a dedicated thread, so that the encoding and compression
+    // of the binary G-code blocks overlaps with the post-processing of the following G-code lines.
+    class AsyncBinarizer
+    {
+        // Maximum number of G-code chunks waiting for the binarizer, bounds the memory held by the queue.
+        // G-code is collected into chunks of at least MinChunkSize bytes before being queued, so that
+        // the worker thread is not woken up for every few lines written by ExportLines::write().
+        enum { MaxQueuedChunks = 16, MinChunkSize = 65536 };
+
+        bgcode::binarize::Binarizer& m_binarizer;
+        boost::thread                m_thread;
+        std::mutex                   m_mutex;
+        std::condition_variable      m_cv_not_empty;
+        std::condition_variable      m_cv_not_full;
+        std::deque<std::string>      m_queue;
+        // G-code collected for the next chunk to be queued.
+        std::string                  m_chunk;
+        bool                         m_finished{ false };
+        bool                         m_error{ false };
+        // Exception thrown by the binarizer on the worker thread, rethrown on the exporting thread.
+        std::exception_ptr           m_exception;
+
+    public:
+        explicit AsyncBinarizer(bgcode::binarize::Binarizer& binarizer) : m_binarizer(binarizer) {
+            if (m_binarizer.is_enabled())
+                m_thread = create_thread([this]() { this->run(); });
+        }
+        ~AsyncBinarizer() {
+            // Post-processing failed or was canceled, the queued data will be thrown away.
+            {
+                std::scoped_lock<std::mutex> lock(m_mutex);
+                m_queue.clear();
+            }
+            this->stop();
+        }
+
+        bool is_enabled() const { return m_binarizer.is_enabled(); }
+
+        void append_gcode(std::string&& gcode) {
+            if (m_chunk.empty())
+                m_chunk = std::move(gcode);
+            else
+                m_chunk += gcode;
+            if (m_chunk.size() >= size_t(MinChunkSize))
+                this->push_chunk();
+        }
+
+        // Queue the remaining G-code, wait until the binarizer consumes all the queued G-code, then finalize the binary file.
+        void finalize() {
+            this->push_chunk();
+            this->stop();
+            if (m_error)
+                this->rethrow_error();
+            if (m_binarizer.finalize() != bgcode::core::EResult::Success)
+                throw Slic3r::RuntimeError("Error while finalizing the gcode binarizer.");
+        }
+
+    private:
+        void push_chunk() {
+            if (m_chunk.empty())
+                return;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv_not_full.wait(lock, [this]() { return m_queue.size() < size_t(MaxQueuedChunks) || m_error; });
+                if (m_error)
+                    this->rethrow_error();
+                m_queue.emplace_back(std::move(m_chunk));
+            }
+            m_chunk.clear();
+            m_cv_not_empty.notify_one();
+        }
+
+        void stop() {
+            if (m_thread.joinable()) {
+                {
+                    std::scoped_lock<std::mutex> lock(m_mutex);
+                    m_finished = true;
+                }
+                m_cv_not_empty.notify_one();
+                m_thread.join();
+            }
+        }
+
+        void run() {
+            for (;;) {
+                std::string gcode;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv_not_empty.wait(lock, [this]() { return !m_queue.empty() || m_finished; });
+                    if (m_queue.empty())
+                        return;
+                    gcode = std::move(m_queue.front());
+                    m_queue.pop_front();
+                }
+                m_cv_not_full.notify_one();
+                std::exception_ptr exception;
+                bool               success = false;
+                try {
+                    success = m_binarizer.append_gcode(gcode) == bgcode::core::EResult::Success;
+                } catch (...) {
+                    // An exception escaping the thread function would call std::terminate().
+                    exception = std::current_exception();
+                }
+                if (!success) {
+                    {
+                        std::scoped_lock<std::mutex> lock(m_mutex);
+                        m_error = true;
+                        m_exception = std::move(exception);
+                        m_queue.clear();
+                    }
+                    m_cv_not_full.notify_one();
+                    return;
+                }
+            }
+        }
+
+        void rethrow_error() const {
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+            throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
+        }
+    };
+
     // Helper class to modify and export gcode to file
     class ExportLines
     {
@@ -3898,10 +4058,10 @@ void GCodeProcessor::post_process()
         size_t m_times_cache_id{ 0 };
         size_t m_out_file_pos{ 0 };
 
-        bgcode::binarize::Binarizer& m_binarizer;
+        AsyncBinarizer& m_binarizer;
 
     public:
-        ExportLines(bgcode::binarize::Binarizer& binarizer, EWriteType type,
+        ExportLines(AsyncBinarizer& binarizer, EWriteType type,
             const std::array<TimeMachine, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)>& machines)
 #ifndef NDEBUG
         : m_statistics(*this), m_binarizer(binarizer), m_write_type(type), m_machines(machines) {}
@@ -4050,10 +4210,8 @@ void GCodeProcessor::post_process()
                 }
             }
 
-            if (m_binarizer.is_enabled()) {
-                if (m_binarizer.append_gcode(out_string) != bgcode::core::EResult::Success)
-                    throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
-            }
+            if (m_binarizer.is_enabled())
+                m_binarizer.append_gcode(std::move(out_string));
             else {
                 write_to_file(out, out_string, result, out_path);
                 update_lines_ends_and_out_file_pos(out_string, result.lines_ends.front(), &m_out_file_pos);
@@ -4073,10 +4231,8 @@ void GCodeProcessor::post_process()
             m_statistics.remove_all_lines();
 #endif // NDEBUG
 
-            if (m_binarizer.is_enabled()) {
-                if (m_binarizer.append_gcode(out_string) != bgcode::core::EResult::Success)
-                    throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
-            }
+            if (m_binarizer.is_enabled())
+                m_binarizer.append_gcode(std::move(out_string));
             else {
                 write_to_file(out, out_string, result, out_path);
                 update_lines_ends_and_out_file_pos(out_string, result.lines_ends.front(), &m_out_file_pos);
@@ -4111,12 +4267,13 @@ void GCodeProcessor::post_process()
         }
     };
 
-    ExportLines export_lines(m_binarizer, m_result.backtrace_enabled ? ExportLines::EWriteType::ByTime : ExportLines::EWriteType::BySize,
+    AsyncBinarizer async_binarizer(m_binarizer);
+    ExportLines export_lines(async_binarizer, m_result.backtrace_enabled ? ExportLines::EWriteType::ByTime : ExportLines::EWriteType::BySize,
         m_time_processor.machines);
 
-    // replace placeholder lines with the proper final value
+    // replace placeholder lines with the proper final value, the replacement lines are passed to append_line
     // gcode_line is in/out parameter, to reduce expensive memory allocation
-    auto process_placeholders = [&](std::string& gcode_line) {
+    auto process_placeholders = [&](std::string& gcode_line, auto&& append_line) {
         bool processed = false;
 
         // remove trailing '\n'
@@ -4130,7 +4287,7 @@ void GCodeProcessor::post_process()
                     const TimeMachine& machine = m_time_processor.machines[i];
                     if (machine.enabled) {
                         // export pair <percent, remaining time>
-                        export_lines.append_line(format_line_M73_main(machine.line_m73_main_mask.c_str(),
+                        append_line(format_line_M73_main(machine.line_m73_main_mask.c_str(),
                             (line == reserved_tag(ETags::First_Line_M73_Placeholder)) ? 0 : 100,
                             (line == reserved_tag(ETags::First_Line_M73_Placeholder)) ? time_in_minutes(machine.time) : 0));
                         processed = true;
@@ -4138,7 +4295,7 @@ void GCodeProcessor::post_process()
                         // export remaining time to next printer stop
                         if (line == reserved_tag(ETags::First_Line_M73_Placeholder) && !machine.stop_times.empty()) {
                             const int to_export_stop = time_in_minutes(machine.stop_times.front().elapsed_time);
-                            export_lines.append_line(format_line_M73_stop_int(machine.line_m73_stop_mask.c_str(), to_export_stop));
+                            append_line(format_line_M73_stop_int(machine.line_m73_stop_mask.c_str(), to_export_stop));
                             last_exported_stop[i] = to_export_stop;
                         }
                     }
@@ -4153,7 +4310,7 @@ void GCodeProcessor::post_process()
                         sprintf(buf, "; estimated printing time (%s mode) = %s\n",
                             (mode == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
                             get_time_dhms(machine.time).c_str());
-                        export_lines.append_line(buf);
+                        append_line(buf);
                         processed = true;
                     }
                 }
@@ -4165,7 +4322,7 @@ void GCodeProcessor::post_process()
                         sprintf(buf, "; estimated first layer printing time (%s mode) = %s\n",
                             (mode == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
                             get_time_dhms(machine.first_layer_time).c_str());
-                        export_lines.append_line(buf);
+                        append_line(buf);
                         processed = true;
                     }
                 }
@@ -4343,6 +4500,59 @@ void GCodeProcessor::post_process()
         }
     };
 
+    if (post_process_footer_only) {
+        const size_t footer_start = *m_exported_gcode.footer_start;
+        std::string footer;
+        {
+            if (fseek_64(in.f, footer_start) != 0)
+                throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nError while reading from file.\n"));
+            std::vector<char> buffer(65536, 0);
+            for (size_t cnt_read = 0; (cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f)) > 0;)
+                footer.append(buffer.data(), cnt_read);
+            if (::ferror(in.f))
+                throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nError while reading from file.\n"));
+            in.close();
+        }
+
+        std::string out_footer;
+        out_footer.reserve(footer.size() + 1024);
+        for (size_t line_begin = 0; line_begin < footer.size();) {
+            const size_t line_end = std::min(footer.find('\n', line_begin), footer.size());
+            gcode_line.assign(footer, line_begin, line_end - line_begin);
+            gcode_line += "\n";
+            line_begin = line_end + 1;
+            if (!process_placeholders(gcode_line, [&out_footer](const std::string& line) { out_footer += line; })) {
+                process_used_filament(gcode_line);
+                out_footer += gcode_line;
+            }
+        }
+        gcode_line.clear();
+
+        // The footer may grow or shrink, overwrite it and trim the file.
+        FilePtr inout{ boost::nowide::fopen(m_result.filename.c_str(), "r+b") };
+        if (inout.f == nullptr || fseek_64(inout.f, footer_start) != 0)
+            throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for writing.\n"));
+        ::fwrite(out_footer.data(), 1, out_footer.size(), inout.f);
+        if (::ferror(inout.f))
+            throw Slic3r::RuntimeError("GCode processor post process export failed.\nIs the disk full?");
+        inout.close();
+        boost::system::error_code ec;
+        boost::filesystem::resize_file(m_result.filename, footer_start + out_footer.size(), ec);
+        if (ec)
+            throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\n") + ec.message());
+
+        // Line ends of the body were collected while exporting, the moves' gcode ids are still valid.
+        std::vector<size_t> lines_ends = std::move(m_exported_gcode.lines_ends);
+        lines_ends.erase(std::upper_bound(lines_ends.begin(), lines_ends.end(), footer_start), lines_ends.end());
+        size_t out_file_pos = footer_start;
+        update_lines_ends_and_out_file_pos(out_footer, lines_ends, &out_file_pos);
+        m_exported_gcode.reset();
+        m_result.lines_ends.clear();
+        m_result.lines_ends.emplace_back(std::move(lines_ends));
+        return;
+    }
+
+    m_exported_gcode.reset();
     m_result.lines_ends.clear();
     m_result.lines_ends.emplace_back(std::vector<size_t>());
 
@@ -4378,7 +4588,7 @@ void GCodeProcessor::post_process()
                     gcode_line += "\n";
                     const unsigned int internal_g1_lines_counter = export_lines.update(gcode_line, line_id, g1_lines_counter);
                     // replace placeholder lines
-                    bool processed = process_placeholders(gcode_line);
+                    bool processed = process_placeholders(gcode_line, [&export_lines](const std::string& line) { export_lines.append_line(line); });
                     if (processed)
                         gcode_line.clear();
                     if (!processed)
@@ -4426,10 +4636,8 @@ void GCodeProcessor::post_process()
 
     export_lines.flush(out, m_result, out_path);
 
-    if (m_binarizer.is_enabled()) {
-        if (m_binarizer.finalize() != bgcode::core::EResult::Success)
-            throw Slic3r::RuntimeError("Error while finalizing the gcode binarizer.");
-    }
+    if (m_binarizer.is_enabled())
+        async_binarizer.finalize();
 
     out.close();
     in.close();
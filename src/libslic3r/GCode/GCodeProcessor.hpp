@@ -486,6 +486,23 @@ namespace Slic3r {
         bgcode::binarize::Binarizer m_binarizer;
         static bgcode::binarize::BinarizerConfig s_binarizer_config;
 
+        // Layout of the G-code passed to process_buffer() while exporting, which is exactly the content of the exported file.
+        // Used by post_process() to patch the footer of the file in place instead of rewriting the whole file.
+        struct ExportedGCode
+        {
+            // Number of bytes written so far.
+            size_t size{ 0 };
+            // Positions following each '\n', as stored into GCodeProcessorResult::lines_ends.
+            std::vector<size_t> lines_ends;
+            // A '\r' was written, the line numbering of post_process() would differ.
+            bool has_cr{ false };
+            // Offset of the footer containing the placeholders to be filled in by post_process().
+            std::optional<size_t> footer_start;
+
+            void reset() { size = 0; lines_ends.clear(); has_cr = false; footer_start.reset(); }
+        };
+        ExportedGCode m_exported_gcode;
+
         EUnits m_units;
         EPositioningType m_global_positioning_type;
         EPositioningType m_e_local_positioning_type;
@@ -598,6 +615,9 @@ namespace Slic3r {
             m_result.moves.emplace_back(GCodeProcessorResult::MoveVertex());
         }
         void process_buffer(const std::string& buffer);
+        // Mark the start of the G-code footer (print statistics, placeholders and config). From this point on
+        // the G-code must not contain any moves.
+        void mark_footer_start() { m_exported_gcode.footer_start = m_exported_gcode.size; }
         void finalize(bool post_process);
 
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
@@ -749,6 +769,8 @@ namespace Slic3r {
         // 1) add remaining time lines M73 and update moves' gcode ids accordingly
         // 2) update used filament data
         void post_process();
+        // Check whether post_process() may only rewrite the footer of the exported file, leaving the rest of the file untouched.
+        bool can_post_process_footer_only() const;
 
         void store_move_vertex(EMoveType type, bool internal_only = false);
 
@@ -8,6 +8,7 @@
 #include "libslic3r/ShortEdgeCollapse.hpp"
 #include "libslic3r/GCode/ModelVisibility.hpp"
 #include "libslic3r/AABBTreeIndirect.hpp"
+#include "libslic3r/AABBTreeWide.hpp"
 #include "admesh/stl.h"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/libslic3r.h"
@@ -96,6 +97,7 @@ Vec3f sample_power_cosine_hemisphere(const Vec2f &samples, float power) {
 
 std::vector<float> raycast_visibility(
     const AABBTreeIndirect::Tree<3, float> &raycasting_tree,
+    const AABBTreeIndirect::WideTree4 &raycasting_wide_tree,
     const indexed_triangle_set &triangles,
     const TriangleSetSamples &samples,
     size_t negative_volumes_start_index,
@@ -123,9 +125,11 @@ std::vector<float> raycast_visibility(
     std::vector<float> result(samples.positions.size());
     tbb::parallel_for(tbb::blocked_range<size_t>(0, result.size()),
             [&triangles, &precomputed_sample_directions, model_contains_negative_parts, negative_volumes_start_index,
-                    &raycasting_tree, &result, &samples, &params](tbb::blocked_range<size_t> r) {
+                    &raycasting_tree, &raycasting_wide_tree, &result, &samples, &params](tbb::blocked_range<size_t> r) {
                 // Maintaining hits memory outside of the loop, so it does not have to be reallocated for each query.
                 std::vector<igl::Hit> hits;
+                std::vector<Vec3d> ray_origins;
+                std::vector<Vec3d> ray_dirs;
                 for (size_t s_idx = r.begin(); s_idx < r.end(); ++s_idx) {
                     result[s_idx] = 1.0f;
                     const float decrease_step = 1.0f
@@ -137,49 +141,54 @@ std::vector<float> raycast_visibility(
                     Frame f;
                     f.set_from_z(normal);
 
-                    for (const auto &dir : precomputed_sample_directions) {
-                        Vec3f final_ray_dir = (f.to_world(dir));
-                        if (!model_contains_negative_parts) {
-                            igl::Hit hitpoint;
-                            // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
-                            // direction.
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            bool hit = AABBTreeIndirect::intersect_ray_first_hit(triangles.vertices,
-                                    triangles.indices, raycasting_tree, ray_origin_d, final_ray_dir_d, hitpoint);
-                            if (hit && its_face_normal(triangles, hitpoint.id).dot(final_ray_dir) <= 0) {
+                    if (!model_contains_negative_parts) {
+                        // All the rays of a sample share their origin, cast them as coherent packets over the wide tree.
+                        const Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
+                        ray_origins.assign(precomputed_sample_directions.size(), ray_origin_d);
+                        ray_dirs.clear();
+                        for (const auto &dir : precomputed_sample_directions)
+                            ray_dirs.emplace_back(f.to_world(dir).cast<double>());
+                        AABBTreeIndirect::intersect_rays_first_hit(triangles.vertices, triangles.indices,
+                                raycasting_wide_tree, ray_origins, ray_dirs, hits);
+                        for (size_t ray_idx = 0; ray_idx < hits.size(); ++ray_idx)
+                            if (hits[ray_idx].id >= 0
+                                    && its_face_normal(triangles, hits[ray_idx].id).dot(ray_dirs[ray_idx].cast<float>()) <= 0) {
                                 result[s_idx] -= decrease_step;
                             }
-                        } else { //TODO improve logic for order based boolean operations - consider order of volumes
-                            bool casting_from_negative_volume = samples.triangle_indices[s_idx]
-                                    >= negative_volumes_start_index;
-
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            if (casting_from_negative_volume) { // if casting from negative volume face, invert direction, change start pos
-                                final_ray_dir = -1.0 * final_ray_dir;
-                                ray_origin_d = (center - normal * 0.01f).cast<double>();
-                            }
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            bool some_hit = AABBTreeIndirect::intersect_ray_all_hits(triangles.vertices,
-                                    triangles.indices, raycasting_tree,
-                                    ray_origin_d, final_ray_dir_d, hits);
-                            if (some_hit) {
-                                int counter = 0;
-                                // NOTE: iterating in reverse, from the last hit for one simple reason: We know the state of the ray at that point;
-                                //  It cannot be inside model, and it cannot be inside negative volume
-                                for (int hit_index = int(hits.size()) - 1; hit_index >= 0; --hit_index) {
-                                    Vec3f face_normal = its_face_normal(triangles, hits[hit_index].id);
-                                    if (hits[hit_index].id >= int(negative_volumes_start_index)) { //negative volume hit
-                                        counter -= sgn(face_normal.dot(final_ray_dir)); // if volume face aligns with ray dir, we are leaving negative space
-                                        // which in reverse hit analysis means, that we are entering negative space :) and vice versa
-                                    } else {
-                                        counter += sgn(face_normal.dot(final_ray_dir));
-                                    }
-                                }
-                                if (counter == 0) {
-                                    result[s_idx] -= decrease_step;
+                        continue;
+                    }
+
+                    for (const auto &dir : precomputed_sample_directions) {
+                        Vec3f final_ray_dir = (f.to_world(dir));
+                        //TODO improve logic for order based boolean operations - consider order of volumes
+                        bool casting_from_negative_volume = samples.triangle_indices[s_idx]
+                                >= negative_volumes_start_index;
+
+                        Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
+                        if (casting_from_negative_volume) { // if casting from negative volume face, invert direction, change start pos
+                            final_ray_dir = -1.0 * final_ray_dir;
+                            ray_origin_d = (center - normal * 0.01f).cast<double>();
+                        }
+                        Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
+                        bool some_hit = AABBTreeIndirect::intersect_ray_all_hits(triangles.vertices,
+                                triangles.indices, raycasting_tree,
+                                ray_origin_d, final_ray_dir_d, hits);
+                        if (some_hit) {
+                            int counter = 0;
+                            // NOTE: iterating in reverse, from the last hit for one simple reason: We know the state of the ray at that point;
+                            //  It cannot be inside model, and it cannot be inside negative volume
+                            for (int hit_index = int(hits.size()) - 1; hit_index >= 0; --hit_index) {
+                                Vec3f face_normal = its_face_normal(triangles, hits[hit_index].id);
+                                if (hits[hit_index].id >= int(negative_volumes_start_index)) { //negative volume hit
+                                    counter -= sgn(face_normal.dot(final_ray_dir)); // if volume face aligns with ray dir, we are leaving negative space
+                                    // which in reverse hit analysis means, that we are entering negative space :) and vice versa
+                                } else {
+                                    counter += sgn(face_normal.dot(final_ray_dir));
                                 }
                             }
+                            if (counter == 0) {
+                                result[s_idx] -= decrease_step;
+                            }
                         }
                     }
                 }
@@ -268,10 +277,16 @@ Visibility::Visibility(
     auto raycasting_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(triangle_set.vertices,
             triangle_set.indices);
 
+    throw_if_canceled();
+    // Rays of models without negative volumes are cast in packets over a wide tree.
+    AABBTreeIndirect::WideTree4 raycasting_wide_tree;
+    if (negative_volumes_start_index == triangle_set.indices.size())
+        raycasting_wide_tree.build(raycasting_tree);
+
     throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug)
     << "SeamPlacer: build AABB tree: end";
-    this->mesh_samples_visibility = Impl::raycast_visibility(raycasting_tree, triangle_set, this->mesh_samples,
+    this->mesh_samples_visibility = Impl::raycast_visibility(raycasting_tree, raycasting_wide_tree, triangle_set, this->mesh_samples,
             negative_volumes_start_index, params);
     throw_if_canceled();
 }
@@ -306,4 +321,40 @@ float Visibility::calculate_point_visibility(const Vec3f &position) const {
     return total_visibility / total_weight;
 }
 
+MeshesKey visibility_key(
+    const Transform3d &obj_transform,
+    const ModelVolumePtrs &volumes,
+    const Visibility::Params &params
+) {
+    MeshesKey key;
+    for (const ModelVolume *model_volume : volumes) {
+        if (model_volume->type() == ModelVolumeType::MODEL_PART
+                || model_volume->type() == ModelVolumeType::NEGATIVE_VOLUME) {
+            key.add_value(int(model_volume->type()));
+            key.add_mesh(model_volume->mesh().its);
+            key.add_transform(model_volume->get_matrix());
+        }
+    }
+    key.add_transform(obj_transform);
+    key.add_value(params.raycasting_visibility_samples_count);
+    key.add_value(params.fast_decimation_triangle_count_target);
+    key.add_value(params.sqr_rays_per_sample_point);
+    return key;
+}
+
+std::shared_ptr<const Visibility> VisibilityCache::get(
+    const Transform3d &obj_transform,
+    const ModelVolumePtrs &volumes,
+    const Visibility::Params &params,
+    const std::function<void(void)> &throw_if_canceled
+) {
+    return m_cache.get(visibility_key(obj_transform, volumes, params), [&]() {
+        return std::make_shared<const Visibility>(obj_transform, volumes, params, throw_if_canceled);
+    });
+}
+
+void VisibilityCache::clear() {
+    m_cache.clear();
+}
+
 }
@@ -5,8 +5,10 @@
 #include <functional>
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 #include "libslic3r/KDTreeIndirect.hpp"
+#include "libslic3r/KeyedCache.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/TriangleSetSampling.hpp"
@@ -52,5 +54,31 @@ struct Visibility
     float calculate_point_visibility(const Vec3f &position) const;
 };
 
+// Key identifying the input of the Visibility calculation: contents of the model parts and negative volumes,
+// their transformations, the object transformation and the visibility parameters.
+MeshesKey visibility_key(
+    const Transform3d &obj_transform,
+    const ModelVolumePtrs &volumes,
+    const Visibility::Params &params
+);
+
+// Holds the Visibility of a single object, so that it is not recalculated when G-code export is invalidated
+// by a config change not affecting the object geometry. Thread safe: concurrent calls with the same key
+// wait for a single calculation.
+class VisibilityCache
+{
+public:
+    std::shared_ptr<const Visibility> get(
+        const Transform3d &obj_transform,
+        const ModelVolumePtrs &volumes,
+        const Visibility::Params &params,
+        const std::function<void(void)> &throw_if_canceled
+    );
+    void clear();
+
+private:
+    KeyedCache<Visibility, MeshesKey> m_cache;
+};
+
 } // namespace Slic3r::ModelInfo
 #endif // libslic3r_ModelVisibility_hpp_
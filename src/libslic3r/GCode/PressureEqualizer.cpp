@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <array>
 #include <iterator>
+#include <string_view>
 #include <limits>
 #include <cctype>
 #include <cstdlib>
@@ -210,7 +211,7 @@ LayerResult PressureEqualizer::process_layer(LayerResult &&input)
     m_gcode_lines.erase(m_gcode_lines.begin(), m_gcode_lines.begin() + int(next_layer_first_idx));
 
     if (output_buffer_length > 0)
-        prev_layer_result->gcode = std::string(output_buffer.data());
+        prev_layer_result->gcode = std::string(output_buffer.data(), output_buffer_length);
 
     assert(!input.nop_layer_result || m_layer_results.empty());
     LayerResult out = *prev_layer_result;
@@ -299,9 +300,11 @@ bool PressureEqualizer::process_line(const char *line, const char *line_end, GCo
     buf.max_volumetric_extrusion_rate_slope_negative = 0.f;
     buf.extrusion_role = m_current_extrusion_role;
 
-    std::string str_line(line, line_end);
-    const bool found_extrude_set_speed_tag = boost::contains(str_line, EXTRUDE_SET_SPEED_TAG);
-    const bool found_extrude_end_tag = boost::contains(str_line, EXTRUDE_END_TAG);
+    // The tags are G-code comments, thus only the comment is searched, without copying the line.
+    const std::string_view sline(line, len);
+    const std::string_view comment = sline.substr(std::min(sline.find(';'), len));
+    const bool found_extrude_set_speed_tag = comment.find(EXTRUDE_SET_SPEED_TAG) != std::string_view::npos;
+    const bool found_extrude_end_tag = comment.find(EXTRUDE_END_TAG) != std::string_view::npos;
     assert(!found_extrude_set_speed_tag || !found_extrude_end_tag);
 
     if (found_extrude_set_speed_tag)
@@ -48,4 +48,28 @@ bool Painting::is_blocked(const Vec3f &position, float radius) const {
         blockers.vertices, blockers.indices, blockers_tree, position, radius_sqr
     );
 }
+MeshesKey painting_key(const Transform3d &obj_transform, const ModelVolumePtrs &volumes) {
+    MeshesKey key;
+    for (const ModelVolume *mv : volumes) {
+        if (mv->is_seam_painted()) {
+            // The object ID and the timestamp identify the content of the painting.
+            key.add_value(mv->seam_facets.id().id);
+            key.add_value(mv->seam_facets.timestamp());
+            key.add_mesh(mv->mesh().its);
+            key.add_transform(mv->get_matrix());
+        }
+    }
+    key.add_transform(obj_transform);
+    return key;
+}
+
+std::shared_ptr<const Painting> PaintingCache::get(const Transform3d &obj_transform, const ModelVolumePtrs &volumes) {
+    return m_cache.get(painting_key(obj_transform, volumes), [&]() {
+        return std::make_shared<const Painting>(obj_transform, volumes);
+    });
+}
+
+void PaintingCache::clear() {
+    m_cache.clear();
+}
 } // namespace Slic3r::Seams::ModelInfo
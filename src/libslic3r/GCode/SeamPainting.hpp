@@ -1,7 +1,11 @@
 #ifndef libslic3r_GlobalModelInfo_hpp_
 #define libslic3r_GlobalModelInfo_hpp_
 
+#include <cstddef>
+#include <memory>
+
 #include "libslic3r/AABBTreeIndirect.hpp"
+#include "libslic3r/KeyedCache.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Model.hpp"
 #include "admesh/stl.h"
@@ -21,5 +25,21 @@ private:
     AABBTreeIndirect::Tree<3, float> enforcers_tree;
     AABBTreeIndirect::Tree<3, float> blockers_tree;
 };
+
+// Key identifying the input of the Painting: seam painting of the volumes, their meshes and transformations
+// and the object transformation.
+MeshesKey painting_key(const Transform3d &obj_transform, const ModelVolumePtrs &volumes);
+
+// Holds the Painting of a single object, so that the AABB trees over the painted facets are not rebuilt
+// when G-code export is invalidated by a config change not affecting the object geometry.
+class PaintingCache
+{
+public:
+    std::shared_ptr<const Painting> get(const Transform3d &obj_transform, const ModelVolumePtrs &volumes);
+    void clear();
+
+private:
+    KeyedCache<Painting, MeshesKey> m_cache;
+};
 } // namespace Slic3r::Seams::ModelInfo
 #endif // libslic3r_GlobalModelInfo_hpp_
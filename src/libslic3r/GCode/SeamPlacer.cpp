@@ -7,6 +7,8 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 
 #include "SeamPlacer.hpp"
 
@@ -20,7 +22,7 @@
 
 namespace Slic3r::Seams {
 
-using ObjectPainting = std::map<const PrintObject*, ModelInfo::Painting>;
+using ObjectPainting = std::map<const PrintObject*, std::shared_ptr<const ModelInfo::Painting>>;
 
 ObjectLayerPerimeters get_perimeters(
     SpanOfConstPtrs<PrintObject> objects,
@@ -31,7 +33,7 @@ ObjectLayerPerimeters get_perimeters(
     ObjectLayerPerimeters result;
 
     for (const PrintObject *print_object : objects) {
-        const ModelInfo::Painting &painting{object_painting.at(print_object)};
+        const ModelInfo::Painting &painting{*object_painting.at(print_object)};
         throw_if_canceled();
 
         const std::vector<Geometry::Extrusions> extrusions{
@@ -65,24 +67,53 @@ Perimeters::LayerPerimeters sort_to_layers(Shells::Shells<> &&shells) {
     return result;
 }
 
+using ObjectVisibility = std::unordered_map<const PrintObject *, std::shared_ptr<const Slic3r::ModelInfo::Visibility>>;
+
+ObjectVisibility get_visibility(
+    const ObjectLayerPerimeters &seam_data,
+    const Params &params,
+    const std::function<void(void)> &throw_if_canceled
+) {
+    std::vector<const PrintObject *> aligned_objects;
+    for (const auto &[print_object, layer_perimeters] : seam_data) {
+        if (print_object->config().seam_position.value == spAligned) {
+            aligned_objects.push_back(print_object);
+        }
+    }
+
+    // Each object is cached separately, the calculation itself is parallel as well.
+    std::vector<std::shared_ptr<const Slic3r::ModelInfo::Visibility>> visibilities(aligned_objects.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, aligned_objects.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const PrintObject *print_object{aligned_objects[i]};
+            visibilities[i] = print_object->seam_visibility_cache().get(
+                print_object->trafo_centered(), print_object->model_object()->volumes, params.visibility,
+                throw_if_canceled
+            );
+        }
+    });
+
+    ObjectVisibility result;
+    for (size_t i = 0; i < aligned_objects.size(); ++i) {
+        result.emplace(aligned_objects[i], std::move(visibilities[i]));
+    }
+    return result;
+}
+
 ObjectSeams precalculate_seams(
     const Params &params,
     ObjectLayerPerimeters &&seam_data,
     const std::function<void(void)> &throw_if_canceled
 ) {
     ObjectSeams result;
+    const ObjectVisibility object_visibility{get_visibility(seam_data, params, throw_if_canceled)};
+    throw_if_canceled();
 
     for (auto &[print_object, layer_perimeters] : seam_data) {
         switch (print_object->config().seam_position.value) {
         case spAligned: {
-            const Transform3d transformation{print_object->trafo_centered()};
-            const ModelVolumePtrs &volumes{print_object->model_object()->volumes};
-
-            Slic3r::ModelInfo::Visibility
-                points_visibility{transformation, volumes, params.visibility, throw_if_canceled};
-            throw_if_canceled();
             const Aligned::VisibilityCalculator visibility_calculator{
-                points_visibility, params.convex_visibility_modifier,
+                *object_visibility.at(print_object), params.convex_visibility_modifier,
                 params.concave_visibility_modifier};
 
             Shells::Shells<> shells{Shells::create_shells(std::move(layer_perimeters), params.max_distance)};
@@ -158,7 +189,7 @@ void Placer::init(
     for (const PrintObject *print_object : objects) {
         const Transform3d transformation{print_object->trafo_centered()};
         const ModelVolumePtrs &volumes{print_object->model_object()->volumes};
-        object_painting.emplace(print_object, ModelInfo::Painting{transformation, volumes});
+        object_painting.emplace(print_object, print_object->seam_painting_cache().get(transformation, volumes));
     }
 
     ObjectLayerPerimeters perimeters{get_perimeters(objects, params, object_painting, throw_if_canceled)};
@@ -0,0 +1,255 @@
+#include "ThumbnailRenderer.hpp"
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/blocked_range2d.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "libslic3r/Color.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+namespace Slic3r::GCodeThumbnails {
+
+namespace {
+
+// Triangle projected to the (supersampled) image, z is the depth towards the camera.
+struct ScreenTriangle
+{
+    Vec3f v[3];
+    float intensity;
+};
+
+// Size of a square tile of the supersampled image rasterized by a single task.
+constexpr int TileSize    = 32;
+constexpr int Supersample = 2;
+constexpr float Ambient   = 0.3f;
+
+} // namespace
+
+ThumbnailData render_thumbnail(const std::vector<ThumbnailMesh> &meshes, unsigned int width, unsigned int height, bool transparent_background)
+{
+    ThumbnailData out;
+    if (width == 0 || height == 0)
+        return out;
+    out.set(width, height);
+
+    const ColorRGB orange           = ColorRGB::ORANGE();
+    const Vec3f    object_color     = Vec3f(orange.r(), orange.g(), orange.b());
+    const Vec3f    background_color = Vec3f::Ones();
+
+    // Orthographic camera looking from the isometric direction, the same view as the thumbnails rendered by the GUI.
+    const Vec3d dir_to_camera = Vec3d(-0.5 * std::sqrt(2.), -0.5 * std::sqrt(2.), 1.).normalized();
+    const Vec3d right         = Vec3d::UnitZ().cross(dir_to_camera).normalized();
+    const Vec3d up            = dir_to_camera.cross(right);
+    Transform3d view          = Transform3d::Identity();
+    view.linear().row(0)      = right.transpose();
+    view.linear().row(1)      = up.transpose();
+    view.linear().row(2)      = dir_to_camera.transpose();
+
+    // Transform the vertices to the camera space.
+    std::vector<size_t> triangles_offsets(meshes.size() + 1, 0);
+    for (size_t i = 0; i < meshes.size(); ++ i)
+        triangles_offsets[i + 1] = triangles_offsets[i] + (meshes[i].its ? meshes[i].its->indices.size() : 0);
+    std::vector<std::vector<Vec3f>> vertices(meshes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size()), [&meshes, &vertices, &view](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            if (const indexed_triangle_set *its = meshes[i].its; its) {
+                const Transform3f trafo = (view * meshes[i].trafo).cast<float>();
+                vertices[i].reserve(its->vertices.size());
+                for (const stl_vertex &v : its->vertices)
+                    vertices[i].emplace_back(trafo * v);
+            }
+    });
+
+    BoundingBox3Base<Vec3f> bbox;
+    for (const std::vector<Vec3f> &mesh_vertices : vertices)
+        for (const Vec3f &v : mesh_vertices)
+            bbox.merge(v);
+    if (! bbox.defined) {
+        if (transparent_background)
+            std::fill(out.pixels.begin(), out.pixels.end(), 0);
+        return out;
+    }
+
+    // Zoom to fit the scene into the image with a small margin.
+    const int   ss_width  = int(width) * Supersample;
+    const int   ss_height = int(height) * Supersample;
+    const Vec3f bbox_size = bbox.size();
+    const float scale     = 0.9f * std::min(float(ss_width) / std::max(bbox_size.x(), float(EPSILON)), float(ss_height) / std::max(bbox_size.y(), float(EPSILON)));
+    const Vec3f center    = bbox.center();
+    auto to_screen = [&](const Vec3f &v) {
+        return Vec3f((v.x() - center.x()) * scale + 0.5f * float(ss_width), (v.y() - center.y()) * scale + 0.5f * float(ss_height), v.z());
+    };
+
+    // Project the triangles and shade them by a directional light coming from above left of the camera.
+    const Vec3f light_dir = Vec3f(-0.4f, 0.5f, 0.8f).normalized();
+    std::vector<ScreenTriangle> triangles(triangles_offsets.back());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            if (meshes[i].its == nullptr)
+                continue;
+            const std::vector<Vec3f> &mesh_vertices = vertices[i];
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes[i].its->indices.size()), [&](const tbb::blocked_range<size_t> &faces) {
+                for (size_t f = faces.begin(); f < faces.end(); ++ f) {
+                    const stl_triangle_vertex_indices &face = meshes[i].its->indices[f];
+                    Vec3f                              n    = (mesh_vertices[face[1]] - mesh_vertices[face[0]]).cross(mesh_vertices[face[2]] - mesh_vertices[face[0]]);
+                    ScreenTriangle                    &tri  = triangles[triangles_offsets[i] + f];
+                    for (int j = 0; j < 3; ++ j)
+                        tri.v[j] = to_screen(mesh_vertices[face[j]]);
+                    // Meshes may be mirrored, thus the normal is always turned towards the camera, the depth test sorts out the back faces.
+                    if (n.z() < 0.f)
+                        n = - n;
+                    const float len = n.norm();
+                    tri.intensity   = Ambient + (1.f - Ambient) * (len > 0.f ? std::max(0.f, n.dot(light_dir)) / len : 0.f);
+                }
+            });
+        }
+    });
+    vertices.clear();
+    vertices.shrink_to_fit();
+
+    // Bin the triangles into tiles.
+    const int tiles_x = (ss_width + TileSize - 1) / TileSize;
+    const int tiles_y = (ss_height + TileSize - 1) / TileSize;
+    auto tile_range = [&](const ScreenTriangle &tri, int &x0, int &x1, int &y0, int &y1) {
+        const float min_x = std::min({ tri.v[0].x(), tri.v[1].x(), tri.v[2].x() });
+        const float max_x = std::max({ tri.v[0].x(), tri.v[1].x(), tri.v[2].x() });
+        const float min_y = std::min({ tri.v[0].y(), tri.v[1].y(), tri.v[2].y() });
+        const float max_y = std::max({ tri.v[0].y(), tri.v[1].y(), tri.v[2].y() });
+        x0 = std::clamp(int(std::floor(min_x)) / TileSize, 0, tiles_x - 1);
+        x1 = std::clamp(int(std::floor(max_x)) / TileSize, 0, tiles_x - 1);
+        y0 = std::clamp(int(std::floor(min_y)) / TileSize, 0, tiles_y - 1);
+        y1 = std::clamp(int(std::floor(max_y)) / TileSize, 0, tiles_y - 1);
+    };
+    std::vector<size_t> bin_offsets(size_t(tiles_x * tiles_y) + 1, 0);
+    for (const ScreenTriangle &tri : triangles) {
+        int x0, x1, y0, y1;
+        tile_range(tri, x0, x1, y0, y1);
+        for (int y = y0; y <= y1; ++ y)
+            for (int x = x0; x <= x1; ++ x)
+                ++ bin_offsets[y * tiles_x + x + 1];
+    }
+    for (size_t i = 1; i < bin_offsets.size(); ++ i)
+        bin_offsets[i] += bin_offsets[i - 1];
+    std::vector<unsigned int> bins(bin_offsets.back());
+    {
+        std::vector<size_t> bin_ends(bin_offsets.begin(), bin_offsets.end() - 1);
+        for (size_t t = 0; t < triangles.size(); ++ t) {
+            int x0, x1, y0, y1;
+            tile_range(triangles[t], x0, x1, y0, y1);
+            for (int y = y0; y <= y1; ++ y)
+                for (int x = x0; x <= x1; ++ x)
+                    bins[bin_ends[y * tiles_x + x] ++] = (unsigned int)t;
+        }
+    }
+
+    // Rasterize the tiles in parallel. Each sample keeps the intensity of the closest triangle, negative for an empty sample.
+    std::vector<float> samples(size_t(ss_width * ss_height), -1.f);
+    tbb::parallel_for(tbb::blocked_range2d<int>(0, tiles_y, 0, tiles_x), [&](const tbb::blocked_range2d<int> &range) {
+        std::vector<float> depth(TileSize * TileSize);
+        for (int tile_y = range.rows().begin(); tile_y < range.rows().end(); ++ tile_y)
+            for (int tile_x = range.cols().begin(); tile_x < range.cols().end(); ++ tile_x) {
+                const int tile_idx = tile_y * tiles_x + tile_x;
+                const int tx0      = tile_x * TileSize;
+                const int ty0      = tile_y * TileSize;
+                const int tx1      = std::min(tx0 + TileSize, ss_width);
+                const int ty1      = std::min(ty0 + TileSize, ss_height);
+                std::fill(depth.begin(), depth.end(), -std::numeric_limits<float>::max());
+                for (size_t b = bin_offsets[tile_idx]; b < bin_offsets[tile_idx + 1]; ++ b) {
+                    const ScreenTriangle &tri = triangles[bins[b]];
+                    Vec3f a = tri.v[0], p = tri.v[1], q = tri.v[2];
+                    float area = (p.x() - a.x()) * (q.y() - a.y()) - (p.y() - a.y()) * (q.x() - a.x());
+                    if (area == 0.f)
+                        continue;
+                    if (area < 0.f) {
+                        std::swap(p, q);
+                        area = - area;
+                    }
+                    const int x0 = std::max(tx0, int(std::floor(std::min({ a.x(), p.x(), q.x() }))));
+                    const int x1 = std::min(tx1 - 1, int(std::ceil(std::max({ a.x(), p.x(), q.x() }))));
+                    const int y0 = std::max(ty0, int(std::floor(std::min({ a.y(), p.y(), q.y() }))));
+                    const int y1 = std::min(ty1 - 1, int(std::ceil(std::max({ a.y(), p.y(), q.y() }))));
+                    const float inv_area = 1.f / area;
+                    for (int y = y0; y <= y1; ++ y) {
+                        const float py = float(y) + 0.5f;
+                        for (int x = x0; x <= x1; ++ x) {
+                            const float px = float(x) + 0.5f;
+                            // Edge functions, all non-negative inside the counter-clockwise triangle.
+                            const float w0 = (q.x() - p.x()) * (py - p.y()) - (q.y() - p.y()) * (px - p.x());
+                            const float w1 = (a.x() - q.x()) * (py - q.y()) - (a.y() - q.y()) * (px - q.x());
+                            const float w2 = (p.x() - a.x()) * (py - a.y()) - (p.y() - a.y()) * (px - a.x());
+                            if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+                                continue;
+                            const float z   = (w0 * a.z() + w1 * p.z() + w2 * q.z()) * inv_area;
+                            float      &dst = depth[(y - ty0) * TileSize + x - tx0];
+                            if (z > dst) {
+                                dst = z;
+                                samples[size_t(y) * ss_width + x] = tri.intensity;
+                            }
+                        }
+                    }
+                }
+            }
+    });
+
+    // Resolve the supersampled image.
+    tbb::parallel_for(tbb::blocked_range<int>(0, int(height)), [&](const tbb::blocked_range<int> &range) {
+        for (int y = range.begin(); y < range.end(); ++ y)
+            for (int x = 0; x < int(width); ++ x) {
+                Vec3f color    = Vec3f::Zero();
+                int   coverage = 0;
+                for (int sy = 0; sy < Supersample; ++ sy)
+                    for (int sx = 0; sx < Supersample; ++ sx)
+                        if (float intensity = samples[size_t(y * Supersample + sy) * ss_width + x * Supersample + sx]; intensity >= 0.f) {
+                            color += intensity * object_color;
+                            ++ coverage;
+                        }
+                constexpr float num_samples = float(Supersample * Supersample);
+                float alpha;
+                if (transparent_background) {
+                    // Store the color not premultiplied by alpha.
+                    if (coverage > 0)
+                        color /= float(coverage);
+                    alpha = float(coverage) / num_samples;
+                } else {
+                    color = (color + float(Supersample * Supersample - coverage) * background_color) / num_samples;
+                    alpha = 1.f;
+                }
+                unsigned char *pixel = out.pixels.data() + 4 * (size_t(y) * width + x);
+                for (int c = 0; c < 3; ++ c)
+                    pixel[c] = (unsigned char)std::clamp(std::lround(255.f * color[c]), 0l, 255l);
+                pixel[3] = (unsigned char)std::lround(255.f * alpha);
+            }
+    });
+
+    return out;
+}
+
+ThumbnailsList render_thumbnails(const Print &print, const ThumbnailsParams &params)
+{
+    std::vector<ThumbnailMesh> meshes;
+    for (const PrintObject *object : print.objects())
+        for (const PrintInstance &instance : object->instances()) {
+            if (params.printable_only && ! instance.model_instance->is_printable())
+                continue;
+            // Modifiers, negative volumes and support blockers / enforcers are never rendered, as in the GUI thumbnails.
+            // params.parts_only only hides the SLA supports and pad there, which are not model volumes.
+            for (const ModelVolume *volume : object->model_object()->volumes)
+                if (volume->is_model_part())
+                    meshes.push_back({ &volume->mesh().its, instance.model_instance->get_matrix() * volume->get_matrix() });
+        }
+
+    ThumbnailsList thumbnails;
+    for (const Vec2d &size : params.sizes) {
+        Point isize(size);
+        if (isize.x() > 0 && isize.y() > 0)
+            thumbnails.push_back(render_thumbnail(meshes, (unsigned int)isize.x(), (unsigned int)isize.y(), params.transparent_background));
+    }
+    return thumbnails;
+}
+
+} // namespace Slic3r::GCodeThumbnails
@@ -0,0 +1,36 @@
+#ifndef slic3r_GCode_ThumbnailRenderer_hpp_
+#define slic3r_GCode_ThumbnailRenderer_hpp_
+
+#include <vector>
+
+#include "libslic3r/Point.hpp"
+#include "ThumbnailData.hpp"
+
+struct indexed_triangle_set;
+
+namespace Slic3r {
+class Print;
+} // namespace Slic3r
+
+namespace Slic3r::GCodeThumbnails {
+
+// Mesh with its transformation to world coordinates.
+struct ThumbnailMesh
+{
+    const indexed_triangle_set *its{nullptr};
+    Transform3d                 trafo{Transform3d::Identity()};
+};
+
+// Software (CPU) renderer of thumbnails, usable without an OpenGL context, e.g. from the command line.
+// The meshes are rendered with an orthographic camera looking from the isometric direction, zoomed to fit
+// the whole scene. The image is rasterized in tiles in parallel with 2x2 supersampling.
+// Rows of the returned image are stored bottom up, the same way as the thumbnails rendered by OpenGL.
+ThumbnailData render_thumbnail(const std::vector<ThumbnailMesh> &meshes, unsigned int width, unsigned int height, bool transparent_background);
+
+// Renders one thumbnail for each of params.sizes, showing the instances of the objects of the Print.
+// params.show_bed is ignored, the bed is never rendered.
+ThumbnailsList render_thumbnails(const Print &print, const ThumbnailsParams &params);
+
+} // namespace Slic3r::GCodeThumbnails
+
+#endif // slic3r_GCode_ThumbnailRenderer_hpp_
@@ -14,6 +14,9 @@
 #include "libslic3r/Model.hpp"
 #include "tcbspan/span.hpp"
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 // #define SLIC3R_DEBUG
 
 // Make assert active if SLIC3R_DEBUG
@@ -254,87 +257,87 @@ void ToolOrdering::collect_extruders(
             layer_tools.has_support = true;
     }
 
-    // Extruder overrides are ordered by print_z.
-    std::vector<std::pair<double, unsigned int>>::const_iterator it_per_layer_extruder_override = per_layer_extruder_switches.begin();
-    unsigned int extruder_override = 0;
-
-    std::vector<std::pair<double, unsigned int>>::const_iterator it_per_layer_color_changes = per_layer_color_changes.begin();
-
-    // Collect the object extruders.
-    for (auto layer : object.layers()) {
-        LayerTools &layer_tools = this->tools_for_layer(layer->print_z);
-
-        // Override extruder with the next 
-    	for (; it_per_layer_extruder_override != per_layer_extruder_switches.end() && it_per_layer_extruder_override->first < layer->print_z + EPSILON; ++ it_per_layer_extruder_override)
-    		extruder_override = (int)it_per_layer_extruder_override->second;
-
-        // Store the current extruder override (set to zero if no overriden), so that layer_tools.wiping_extrusions().is_overridable_and_mark() will use it.
-        layer_tools.extruder_override = extruder_override;
-
-        // Append the extruder needed to be picked before performing the color change.
-        for (; it_per_layer_color_changes != per_layer_color_changes.end() && it_per_layer_color_changes->first < layer->print_z + EPSILON; ++it_per_layer_color_changes) {
-            if (std::abs(it_per_layer_color_changes->first - layer->print_z) < EPSILON) {
+    // Collect the object extruders. The layers are processed in parallel, each of them updates just its own LayerTools,
+    // as the print_z of the layers of a single object are further apart than EPSILON.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, object.layers().size()),
+        [this, &object, &per_layer_extruder_switches, &per_layer_color_changes](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            const Layer *layer       = object.layers()[layer_idx];
+            LayerTools  &layer_tools = this->tools_for_layer(layer->print_z);
+
+            // Extruder overrides are ordered by print_z, the last one starting below this layer applies.
+            auto it_per_layer_extruder_override = std::partition_point(per_layer_extruder_switches.begin(), per_layer_extruder_switches.end(),
+                [layer](const std::pair<double, unsigned int> &extruder_switch) { return extruder_switch.first < layer->print_z + EPSILON; });
+            unsigned int extruder_override = it_per_layer_extruder_override == per_layer_extruder_switches.begin() ? 0 : std::prev(it_per_layer_extruder_override)->second;
+
+            // Store the current extruder override (set to zero if no overriden), so that layer_tools.wiping_extrusions().is_overridable_and_mark() will use it.
+            layer_tools.extruder_override = extruder_override;
+
+            // Append the extruder needed to be picked before performing the color change.
+            for (auto it_per_layer_color_changes = std::partition_point(per_layer_color_changes.begin(), per_layer_color_changes.end(),
+                    [layer](const std::pair<double, unsigned int> &color_change) { return color_change.first <= layer->print_z - EPSILON; });
+                 it_per_layer_color_changes != per_layer_color_changes.end() && it_per_layer_color_changes->first < layer->print_z + EPSILON; ++ it_per_layer_color_changes) {
                 assert(layer_tools.extruder_needed_for_color_changer == 0); // Just on color change per layer is allowed.
                 layer_tools.extruder_needed_for_color_changer = it_per_layer_color_changes->second;
                 layer_tools.extruders.emplace_back(it_per_layer_color_changes->second);
             }
-        }
 
-        // What extruders are required to print this object layer?
-        for (const LayerRegion *layerm : layer->regions()) {
-            const PrintRegion &region = layerm->region();
+            // What extruders are required to print this object layer?
+            for (const LayerRegion *layerm : layer->regions()) {
+                const PrintRegion &region = layerm->region();
+
+                if (! layerm->perimeters().empty()) {
+                    bool something_nonoverriddable = true;
+
+                    if (m_print_config_ptr) { // in this case complete_objects is false (see ToolOrdering constructors)
+                        something_nonoverriddable = false;
+                        for (const ExtrusionEntity *eec : layerm->perimeters()) // let's check if there are nonoverriddable entities
+                            if (is_overriddable(dynamic_cast<const ExtrusionEntityCollection&>(*eec), layer_tools, *m_print_config_ptr, object, region))
+                                layer_tools.wiping_extrusions_nonconst().set_something_overridable();
+                            else
+                                something_nonoverriddable = true;
+                    }
 
-            if (! layerm->perimeters().empty()) {
-                bool something_nonoverriddable = true;
+                    if (something_nonoverriddable)
+                   		layer_tools.extruders.emplace_back(extruder_override == 0 ? region.config().perimeter_extruder.value : extruder_override);
 
-                if (m_print_config_ptr) { // in this case complete_objects is false (see ToolOrdering constructors)
-                    something_nonoverriddable = false;
-                    for (const ExtrusionEntity *eec : layerm->perimeters()) // let's check if there are nonoverriddable entities
-                        if (is_overriddable(dynamic_cast<const ExtrusionEntityCollection&>(*eec), layer_tools, *m_print_config_ptr, object, region))
+                    layer_tools.has_object = true;
+                }
+
+                bool has_infill       = false;
+                bool has_solid_infill = false;
+                bool something_nonoverriddable = false;
+                for (const ExtrusionEntity *ee : layerm->fills()) {
+                    // fill represents infill extrusions of a single island.
+                    const auto *fill = dynamic_cast<const ExtrusionEntityCollection*>(ee);
+                    ExtrusionRole role = fill->entities.empty() ? ExtrusionRole::None : fill->entities.front()->role();
+                    if (role.is_solid_infill())
+                        has_solid_infill = true;
+                    else if (role != ExtrusionRole::None)
+                        has_infill = true;
+
+                    if (m_print_config_ptr) {
+                        if (is_overriddable(*fill, layer_tools, *m_print_config_ptr, object, region))
                             layer_tools.wiping_extrusions_nonconst().set_something_overridable();
                         else
                             something_nonoverriddable = true;
+                    }
                 }
 
-                if (something_nonoverriddable)
-               		layer_tools.extruders.emplace_back(extruder_override == 0 ? region.config().perimeter_extruder.value : extruder_override);
-
-                layer_tools.has_object = true;
-            }
-
-            bool has_infill       = false;
-            bool has_solid_infill = false;
-            bool something_nonoverriddable = false;
-            for (const ExtrusionEntity *ee : layerm->fills()) {
-                // fill represents infill extrusions of a single island.
-                const auto *fill = dynamic_cast<const ExtrusionEntityCollection*>(ee);
-                ExtrusionRole role = fill->entities.empty() ? ExtrusionRole::None : fill->entities.front()->role();
-                if (role.is_solid_infill())
-                    has_solid_infill = true;
-                else if (role != ExtrusionRole::None)
-                    has_infill = true;
-
-                if (m_print_config_ptr) {
-                    if (is_overriddable(*fill, layer_tools, *m_print_config_ptr, object, region))
-                        layer_tools.wiping_extrusions_nonconst().set_something_overridable();
-                    else
-                        something_nonoverriddable = true;
+                if (something_nonoverriddable || !m_print_config_ptr) {
+                	if (extruder_override == 0) {
+    	                if (has_solid_infill)
+    	                    layer_tools.extruders.emplace_back(region.config().solid_infill_extruder);
+    	                if (has_infill)
+    	                    layer_tools.extruders.emplace_back(region.config().infill_extruder);
+                	} else if (has_solid_infill || has_infill)
+                		layer_tools.extruders.emplace_back(extruder_override);
                 }
+                if (has_solid_infill || has_infill)
+                    layer_tools.has_object = true;
             }
-
-            if (something_nonoverriddable || !m_print_config_ptr) {
-            	if (extruder_override == 0) {
-	                if (has_solid_infill)
-	                    layer_tools.extruders.emplace_back(region.config().solid_infill_extruder);
-	                if (has_infill)
-	                    layer_tools.extruders.emplace_back(region.config().infill_extruder);
-            	} else if (has_solid_infill || has_infill)
-            		layer_tools.extruders.emplace_back(extruder_override);
-            }
-            if (has_solid_infill || has_infill)
-                layer_tools.has_object = true;
         }
-    }
+    });
 
     for (auto& layer : m_layer_tools) {
         // Sort and remove duplicates
@@ -0,0 +1,109 @@
+#ifndef slic3r_KeyedCache_hpp_
+#define slic3r_KeyedCache_hpp_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+#include <oneapi/tbb/task_arena.h>
+
+#include "admesh/stl.h"
+#include "Point.hpp"
+
+namespace Slic3r {
+
+// Hash of the raw bytes of a contiguous container of trivially copyable values.
+template<class Vector> std::size_t hash_buffer(const Vector &data)
+{
+    return std::hash<std::string_view>{}(std::string_view(
+        reinterpret_cast<const char *>(data.data()), data.size() * sizeof(typename Vector::value_type)));
+}
+
+inline void hash_transform(std::size_t &seed, const Transform3d &transform)
+{
+    for (int i = 0; i < transform.matrix().size(); ++i)
+        boost::hash_combine(seed, transform.matrix().data()[i]);
+}
+
+// Key of an object calculated from meshes. The meshes are identified by a hash of their content,
+// which is not guaranteed to be unique. Therefore the key also holds the numbers of vertices and triangles
+// of the meshes and their transformations, which are compared together with the hash.
+class MeshesKey
+{
+public:
+    // Combine a parameter of the calculation into the key.
+    template<class V> void add_value(const V &value) { boost::hash_combine(m_hash, value); }
+
+    void add_mesh(const indexed_triangle_set &its)
+    {
+        boost::hash_combine(m_hash, hash_buffer(its.vertices));
+        boost::hash_combine(m_hash, hash_buffer(its.indices));
+        m_counts.emplace_back(its.vertices.size());
+        m_counts.emplace_back(its.indices.size());
+    }
+
+    void add_transform(const Transform3d &transform)
+    {
+        hash_transform(m_hash, transform);
+        m_transforms.insert(m_transforms.end(), transform.matrix().data(), transform.matrix().data() + transform.matrix().size());
+    }
+
+    std::size_t hash() const { return m_hash; }
+
+    bool operator==(const MeshesKey &rhs) const { return m_hash == rhs.m_hash && m_counts == rhs.m_counts && m_transforms == rhs.m_transforms; }
+    bool operator!=(const MeshesKey &rhs) const { return !(*this == rhs); }
+
+private:
+    std::size_t         m_hash = 0;
+    std::vector<size_t> m_counts;
+    std::vector<double> m_transforms;
+};
+
+// Holds the last immutable object calculated from an input identified by a key, for example
+// an AABB tree or a KD tree over the meshes of a PrintObject. The object is shared read-only
+// by its users and it is not recalculated as long as the key does not change, therefore it survives
+// invalidation of the steps using it by a config change not affecting the input.
+// Thread safe: concurrent calls with the same key wait for a single calculation.
+template<class T, class Key = std::size_t> class KeyedCache
+{
+public:
+    // Return the cached object if it was calculated for the same key, otherwise calculate it by calling compute(),
+    // which returns std::shared_ptr<const T>. If compute() throws, the cache is left empty.
+    template<class ComputeFn> std::shared_ptr<const T> get(Key key, ComputeFn &&compute)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        if (m_object && m_key == key)
+            return m_object;
+        // Release the old data before calculating the new one to lower the peak memory.
+        m_object.reset();
+        m_key.reset();
+        // Isolate the calculation, which may be parallel, so that this thread does not pick up an unrelated task
+        // waiting for the mutex while holding it.
+        tbb::this_task_arena::isolate([this, &compute]() { m_object = compute(); });
+        m_key = std::move(key);
+        return m_object;
+    }
+
+    // Release the cached object. Users still holding it keep it alive.
+    void clear()
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_object.reset();
+        m_key.reset();
+    }
+
+private:
+    mutable std::mutex         m_mutex;
+    std::optional<Key>         m_key;
+    std::shared_ptr<const T>   m_object;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_KeyedCache_hpp_
@@ -573,8 +573,12 @@ static inline bool layer_needs_raw_backup(const Layer *layer)
 void Layer::backup_untyped_slices()
 {
     if (layer_needs_raw_backup(this)) {
-        for (LayerRegion *layerm : m_regions)
-            layerm->m_raw_slices = to_expolygons(layerm->slices().surfaces);
+        for (LayerRegion *layerm : m_regions) {
+            layerm->m_raw_slices.clear();
+            for (const Surface &surface : layerm->slices().surfaces)
+                layerm->m_raw_slices.append(surface.expolygon);
+            layerm->m_raw_slices.shrink_to_fit();
+        }
     } else {
         assert(m_regions.size() == 1);
         m_regions.front()->m_raw_slices.clear();
@@ -585,7 +589,7 @@ void Layer::restore_untyped_slices()
 {
     if (layer_needs_raw_backup(this)) {
         for (LayerRegion *layerm : m_regions)
-            layerm->m_slices.set(layerm->m_raw_slices, stInternal);
+            layerm->m_slices.set(layerm->m_raw_slices.expolygons(), stInternal);
     } else {
         assert(m_regions.size() == 1);
         m_regions.front()->m_slices.set(this->lslices, stInternal);
@@ -601,7 +605,7 @@ void Layer::restore_untyped_slices_no_extra_perimeters()
     if (layer_needs_raw_backup(this)) {
         for (LayerRegion *layerm : m_regions)
         	if (! layerm->region().config().extra_perimeters.value)
-            	layerm->m_slices.set(layerm->m_raw_slices, stInternal);
+            	layerm->m_slices.set(layerm->m_raw_slices.expolygons(), stInternal);
     } else {
     	assert(m_regions.size() == 1);
     	LayerRegion *layerm = m_regions.front();
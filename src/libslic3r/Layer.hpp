@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -24,6 +25,7 @@
 #include <cstddef>
 
 #include "Line.hpp"
+#include "LayerSpill.hpp"
 #include "libslic3r.h"
 #include "BoundingBox.hpp"
 #include "Flow.hpp"
@@ -201,6 +203,8 @@ public:
     const LayerRegionPtrs&  regions() const { return m_regions; }
     // Test whether whether there are any slices assigned to this layer.
     bool                    empty() const;    
+    // Are the slices and fill surfaces of the layer regions written out to save memory? See Print::set_memory_budget().
+    bool                    spilled() const { return m_spill_record.has_value() && ! m_spill_record->paged_in; }
     void                    make_slices();
     // After creating the slices on all layers, chain the islands overlapping in Z.
     static void             build_up_down_graph(Layer &below, Layer &above);
@@ -270,10 +274,14 @@ private:
         // If the current layer consists of multiple regions, then the fill_expolygons above are split by the source LayerRegion surfaces.
         const std::vector<uint32_t>                                     &layer_region_ids);
 
+    friend class LayerSpillFile;
+
     // Sequential index of layer, 0-based, offsetted by number of raft layers.
     size_t              m_id;
     PrintObject        *m_object;
     LayerRegionPtrs     m_regions;
+    // Set if the data of m_regions was written out into Print::layer_spill().
+    std::optional<LayerSpillRecord> m_spill_record;
 };
 
 class SupportLayer : public Layer 
@@ -11,6 +11,7 @@
 #include <cinttypes>
 
 #include "BoundingBox.hpp"
+#include "CompressedPoints.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "SurfaceCollection.hpp"
 #include "libslic3r/Algorithm/RegionExpansion.hpp"
@@ -151,6 +152,7 @@ public:
 protected:
     friend class Layer;
     friend class PrintObject;
+    friend class LayerSpillFile;
 
     LayerRegion(Layer *layer, const PrintRegion *region) : m_layer(layer), m_region(region) {}
     ~LayerRegion() = default;
@@ -168,7 +170,8 @@ private:
     // Backed up slices before they are split into top/bottom/internal.
     // Only backed up for multi-region layers or layers with elephant foot compensation.
     //FIXME Review whether not to simplify the code by keeping the raw_slices all the time.
-    ExPolygons                  m_raw_slices;
+    // Only read back when the slices are reset after invalidation, thus they are kept compressed.
+    CompressedExPolygons        m_raw_slices;
 
 //FIXME make m_slices public for unit tests
 public:
@@ -0,0 +1,264 @@
+#include "LayerSpill.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/log/trivial.hpp>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "CompressedPoints.hpp"
+#include "Exception.hpp"
+#include "ExPolygon.hpp"
+#include "Layer.hpp"
+#include "LayerRegion.hpp"
+#include "Surface.hpp"
+
+namespace Slic3r {
+
+namespace {
+
+class SpillWriter
+{
+public:
+    std::string data;
+
+    void varint(uint64_t v) { PointsCoding::write_varint(data, v); }
+    void real(double v) { char buf[sizeof(double)]; memcpy(buf, &v, sizeof(double)); data.append(buf, sizeof(double)); }
+
+    void points(const Points &pts) {
+        this->varint(pts.size());
+        PointsCoding::write_points(data, pts);
+    }
+    void expolygon(const ExPolygon &expoly) {
+        this->points(expoly.contour.points);
+        this->varint(expoly.holes.size());
+        for (const Polygon &hole : expoly.holes)
+            this->points(hole.points);
+    }
+    void expolygons(const ExPolygons &expolys) {
+        this->varint(expolys.size());
+        for (const ExPolygon &expoly : expolys)
+            this->expolygon(expoly);
+    }
+    void surfaces(const Surfaces &surfaces) {
+        this->varint(surfaces.size());
+        for (const Surface &surface : surfaces) {
+            this->varint(uint64_t(surface.surface_type));
+            this->real(surface.thickness);
+            this->varint(surface.thickness_layers);
+            this->real(surface.bridge_angle);
+            this->varint(surface.extra_perimeters);
+            this->expolygon(surface.expolygon);
+        }
+    }
+    void polylines(const Polylines &polylines) {
+        this->varint(polylines.size());
+        for (const Polyline &polyline : polylines)
+            this->points(polyline.points);
+    }
+};
+
+class SpillReader
+{
+public:
+    explicit SpillReader(const std::string &data) :
+        m_ptr(reinterpret_cast<const uint8_t*>(data.data())), m_end(m_ptr + data.size()) {}
+
+    bool at_end() const { return m_ptr == m_end; }
+
+    uint64_t varint() {
+        uint64_t v;
+        this->advance(PointsCoding::read_varint(m_ptr, m_end, v));
+        return v;
+    }
+    double real() {
+        if (m_end - m_ptr < ptrdiff_t(sizeof(double)))
+            throw_corrupted();
+        double v;
+        memcpy(&v, m_ptr, sizeof(double));
+        m_ptr += sizeof(double);
+        return v;
+    }
+
+    void points(Points &pts) {
+        const size_t cnt = this->count();
+        this->advance(PointsCoding::read_points(m_ptr, m_end, cnt, pts));
+    }
+    void expolygon(ExPolygon &expoly) {
+        this->points(expoly.contour.points);
+        expoly.holes.assign(this->count(), Polygon());
+        for (Polygon &hole : expoly.holes)
+            this->points(hole.points);
+    }
+    void expolygons(ExPolygons &expolys) {
+        expolys.assign(this->count(), ExPolygon());
+        for (ExPolygon &expoly : expolys)
+            this->expolygon(expoly);
+    }
+    void surfaces(Surfaces &surfaces) {
+        const size_t cnt = this->count();
+        surfaces.reserve(cnt);
+        for (size_t i = 0; i < cnt; ++ i) {
+            Surface &surface         = surfaces.emplace_back(SurfaceType(this->varint()), ExPolygon());
+            surface.thickness        = this->real();
+            surface.thickness_layers = (unsigned short)this->varint();
+            surface.bridge_angle     = this->real();
+            surface.extra_perimeters = (unsigned short)this->varint();
+            this->expolygon(surface.expolygon);
+        }
+    }
+    void polylines(Polylines &polylines) {
+        polylines.assign(this->count(), Polyline());
+        for (Polyline &polyline : polylines)
+            this->points(polyline.points);
+    }
+
+private:
+    [[noreturn]] static void throw_corrupted() { throw Slic3r::RuntimeError("Failed to read back the spilled layer data"); }
+
+    void advance(const uint8_t *ptr) {
+        if (ptr == nullptr)
+            throw_corrupted();
+        m_ptr = ptr;
+    }
+    // Number of items to follow. Each item takes at least a byte.
+    size_t count() {
+        const uint64_t cnt = this->varint();
+        if (cnt > uint64_t(m_end - m_ptr))
+            throw_corrupted();
+        return size_t(cnt);
+    }
+
+    const uint8_t *m_ptr;
+    const uint8_t *m_end;
+};
+
+template<typename T> inline void release(T &v) { T().swap(v); }
+
+} // namespace
+
+LayerSpillFile::LayerSpillFile() :
+    m_path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("PrusaSlicer-layers-%%%%-%%%%-%%%%.tmp"))
+{
+    m_file.open(m_path.string(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (! m_file)
+        throw Slic3r::RuntimeError(std::string("Failed to create temporary file ") + m_path.string());
+}
+
+LayerSpillFile::~LayerSpillFile()
+{
+    m_file.close();
+    boost::system::error_code ec;
+    boost::filesystem::remove(m_path, ec);
+    if (ec)
+        BOOST_LOG_TRIVIAL(error) << "Failed to remove temporary file " << m_path.string() << ": " << ec.message();
+}
+
+size_t LayerSpillFile::footprint(const Layer &layer)
+{
+    auto expolygons_size = [](const ExPolygons &expolys) {
+        size_t out = expolys.size() * sizeof(ExPolygon);
+        for (const ExPolygon &expoly : expolys)
+            out += expoly.num_contours() * sizeof(Polygon) + count_points(expoly) * sizeof(Point);
+        return out;
+    };
+    auto surfaces_size = [](const Surfaces &surfaces) {
+        size_t out = surfaces.size() * sizeof(Surface);
+        for (const Surface &surface : surfaces)
+            out += surface.expolygon.num_contours() * sizeof(Polygon) + count_points(surface.expolygon) * sizeof(Point);
+        return out;
+    };
+    size_t out = 0;
+    for (const LayerRegion *layerm : layer.regions()) {
+        out += surfaces_size(layerm->m_slices.surfaces) + surfaces_size(layerm->m_fill_surfaces.surfaces) +
+               expolygons_size(layerm->m_fill_expolygons) + expolygons_size(layerm->m_fill_expolygons_composite);
+        for (const Polyline &polyline : layerm->m_unsupported_bridge_edges)
+            out += sizeof(Polyline) + polyline.size() * sizeof(Point);
+    }
+    return out;
+}
+
+void LayerSpillFile::spill(Layer &layer)
+{
+    if (! layer.m_spill_record) {
+        SpillWriter writer;
+        for (const LayerRegion *layerm : layer.regions()) {
+            writer.surfaces(layerm->m_slices.surfaces);
+            writer.expolygons(layerm->m_fill_expolygons);
+            writer.expolygons(layerm->m_fill_expolygons_composite);
+            writer.surfaces(layerm->m_fill_surfaces.surfaces);
+            writer.polylines(layerm->m_unsupported_bridge_edges);
+        }
+        LayerSpillRecord record;
+        record.size = writer.data.size();
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            record.offset = m_file_size;
+            m_file.seekp(std::streamoff(record.offset));
+            m_file.write(writer.data.data(), std::streamsize(record.size));
+            if (! m_file)
+                throw Slic3r::RuntimeError(std::string("Failed to write temporary file ") + m_path.string());
+            m_file_size += record.size;
+        }
+        m_bytes_spilled += record.size;
+        layer.m_spill_record = record;
+    }
+    // The bounding boxes of the fill expolygons stay in memory, they will match the fill expolygons read back.
+    for (LayerRegion *layerm : layer.regions()) {
+        release(layerm->m_slices.surfaces);
+        release(layerm->m_fill_expolygons);
+        release(layerm->m_fill_expolygons_composite);
+        release(layerm->m_fill_surfaces.surfaces);
+        release(layerm->m_unsupported_bridge_edges);
+    }
+    layer.m_spill_record->paged_in = false;
+}
+
+std::string LayerSpillFile::read(const LayerSpillRecord &record)
+{
+    std::string data(record.size, 0);
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_file.seekg(std::streamoff(record.offset));
+        m_file.read(data.data(), std::streamsize(record.size));
+        if (! m_file)
+            throw Slic3r::RuntimeError(std::string("Failed to read temporary file ") + m_path.string());
+    }
+    m_bytes_reloaded += record.size;
+    return data;
+}
+
+void LayerSpillFile::page_in(const Layer &layer_const)
+{
+    if (! layer_const.m_spill_record || layer_const.m_spill_record->paged_in)
+        return;
+    // Paging in does not change the logical state of the layer, it only brings back the data released by spill().
+    Layer             &layer = const_cast<Layer&>(layer_const);
+    const std::string  data  = this->read(*layer.m_spill_record);
+    SpillReader        reader(data);
+    for (LayerRegion *layerm : layer.regions()) {
+        reader.surfaces(layerm->m_slices.surfaces);
+        reader.expolygons(layerm->m_fill_expolygons);
+        reader.expolygons(layerm->m_fill_expolygons_composite);
+        reader.surfaces(layerm->m_fill_surfaces.surfaces);
+        reader.polylines(layerm->m_unsupported_bridge_edges);
+    }
+    if (! reader.at_end())
+        throw Slic3r::RuntimeError("Failed to read back the spilled layer data");
+    layer.m_spill_record->paged_in = true;
+}
+
+void LayerSpillFile::page_out(const Layer &layer)
+{
+    if (layer.m_spill_record && layer.m_spill_record->paged_in)
+        this->spill(const_cast<Layer&>(layer));
+}
+
+void LayerSpillFile::reload(Layer &layer)
+{
+    this->page_in(layer);
+    // The space in the file is not reused.
+    layer.m_spill_record.reset();
+}
+
+} // namespace Slic3r
@@ -0,0 +1,88 @@
+#ifndef slic3r_LayerSpill_hpp_
+#define slic3r_LayerSpill_hpp_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/nowide/fstream.hpp>
+
+namespace Slic3r {
+
+class Layer;
+
+// Position of the data of a Layer written out into a LayerSpillFile.
+struct LayerSpillRecord
+{
+    size_t offset   { 0 };
+    size_t size     { 0 };
+    // The data was read back temporarily, it is held both in memory and in the file.
+    bool   paged_in { false };
+};
+
+// Temporary file, into which the Print writes out the slices, the fill surfaces and the fill expolygons
+// of the LayerRegions of finished layers if the Print exceeds its memory budget, see Print::set_memory_budget().
+// These are only read by the G-code export, which pages the layers in one by one, and by the steps
+// processing the layers again after the Print was invalidated, for which the layers are reloaded.
+// The coordinates are compressed by PointsCoding, see CompressedPoints.hpp.
+class LayerSpillFile
+{
+public:
+    // Creates the file in the system temporary directory. The file is deleted by the destructor.
+    LayerSpillFile();
+    ~LayerSpillFile();
+
+    // Estimate of memory held by the data of a layer, which could be written out.
+    static size_t footprint(const Layer &layer);
+
+    // Write out the data of the layer regions and release them from memory.
+    // If the layer was written out before and it was just paged in, the memory is just released.
+    void    spill(Layer &layer);
+    // Read the data of a spilled layer back permanently, so that the layer could be modified.
+    void    reload(Layer &layer);
+    // Read the data of a spilled layer back temporarily for reading. Paging in a layer,
+    // which is not spilled or which is already paged in, is a no-op.
+    void    page_in(const Layer &layer);
+    // Release the data of a layer paged in by page_in().
+    void    page_out(const Layer &layer);
+
+    size_t  bytes_spilled()  const { return m_bytes_spilled; }
+    size_t  bytes_reloaded() const { return m_bytes_reloaded; }
+
+private:
+    std::string             read(const LayerSpillRecord &record);
+
+    boost::filesystem::path m_path;
+    boost::nowide::fstream  m_file;
+    size_t                  m_file_size { 0 };
+    // Reading from and writing into the file.
+    std::mutex              m_mutex;
+    std::atomic<size_t>     m_bytes_spilled  { 0 };
+    std::atomic<size_t>     m_bytes_reloaded { 0 };
+};
+
+// Pages in the spilled layers for the lifetime of this object.
+class LayerSpillPageIn
+{
+public:
+    explicit LayerSpillPageIn(LayerSpillFile *file) : m_file(file) {}
+    ~LayerSpillPageIn() { if (m_file) for (const Layer *layer : m_layers) m_file->page_out(*layer); }
+
+    void add(const Layer *layer) {
+        if (m_file && layer) {
+            m_file->page_in(*layer);
+            m_layers.emplace_back(layer);
+        }
+    }
+
+private:
+    LayerSpillFile            *m_file;
+    std::vector<const Layer*>  m_layers;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_LayerSpill_hpp_
@@ -7,6 +7,7 @@
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/TryCatchSignal.hpp"
 #include "libslic3r/Point.hpp"
+#include "libslic3r/AABBTreeIndirect.hpp"
 
 #undef PI
 
@@ -22,7 +23,15 @@
 #include <CGAL/Exact_integer.h>
 #include <CGAL/Surface_mesh.h>
 #include <CGAL/Cartesian_converter.h>
+#include <CGAL/Side_of_triangle_mesh.h>
+#include <CGAL/intersections.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <optional>
 #include <set>
 #include <csignal>
 #include <map>
@@ -207,20 +216,241 @@ indexed_triangle_set cgal_to_indexed_triangle_set(const CGALMesh &cgalmesh)
 // Boolean operations for CGAL meshes
 // /////////////////////////////////////////////////////////////////////////////
 
+// Fast path for meshes with disjoint surfaces: each connected component of one
+// mesh is either completely inside or completely outside of the other mesh, the
+// result of a boolean operation is a selection of the components. Corefinement
+// is only needed when the surfaces touch.
+
+static std::atomic<bool> s_disjoint_fast_path{true};
+
+void set_disjoint_fast_path(bool enable) { s_disjoint_fast_path = enable; }
+
+using _EpicTriangles = std::vector<std::array<_EpicMesh::Vertex_index, 3>>;
+
+static std::optional<_EpicTriangles> _cgal_triangles(const _EpicMesh &m)
+{
+    _EpicTriangles ret;
+    ret.reserve(m.number_of_faces());
+    for (auto f : m.faces()) {
+        std::array<_EpicMesh::Vertex_index, 3> t;
+        size_t i = 0;
+        for (auto v : m.vertices_around_face(m.halfedge(f))) {
+            if (i == 3) return {};
+            t[i++] = v;
+        }
+        if (i != 3) return {};
+        ret.emplace_back(t);
+    }
+
+    return ret;
+}
+
+static EpicKernel::Triangle_3 _cgal_triangle(const _EpicMesh &m, const std::array<_EpicMesh::Vertex_index, 3> &t)
+{
+    return {m.point(t[0]), m.point(t[1]), m.point(t[2])};
+}
+
+// Candidate pairs of triangles are found by an AABB tree over B and tested in
+// parallel. The kernel predicates are evaluated in floating point with an exact
+// fallback, thus touching triangles are reported too.
+static bool _cgal_surfaces_intersect(const _EpicMesh &A, const _EpicTriangles &ta,
+                                     const _EpicMesh &B, const _EpicTriangles &tb)
+{
+    using Tree        = AABBTreeIndirect::Tree<3, double>;
+    using BoundingBox = Tree::BoundingBox;
+    using VectorType  = Tree::VectorType;
+
+    auto bounding_box = [](const _EpicMesh &m, const std::array<_EpicMesh::Vertex_index, 3> &t) {
+        BoundingBox bb;
+        for (auto v : t) {
+            const auto &p = m.point(v);
+            bb.extend(VectorType(p.x(), p.y(), p.z()));
+        }
+        return bb;
+    };
+
+    struct InputType {
+        size_t             idx() const { return m_idx; }
+        const BoundingBox &bbox() const { return m_bbox; }
+        const VectorType  &centroid() const { return m_centroid; }
+
+        size_t      m_idx;
+        BoundingBox m_bbox;
+        VectorType  m_centroid;
+    };
+
+    std::vector<InputType> input(tb.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tb.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            InputType &n = input[i];
+            n.m_idx      = i;
+            n.m_bbox     = bounding_box(B, tb[i]);
+            n.m_centroid = n.m_bbox.center();
+        }
+    });
+
+    Tree tree;
+    tree.build(std::move(input));
+
+    std::atomic<bool> intersect{false};
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, ta.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end() && !intersect; ++i) {
+            EpicKernel::Triangle_3 tra = _cgal_triangle(A, ta[i]);
+            // Degenerate triangles are left to the corefinement.
+            if (tra.is_degenerate()) {
+                intersect = true;
+                return;
+            }
+
+            AABBTreeIndirect::traverse(tree, AABBTreeIndirect::intersecting(bounding_box(A, ta[i])),
+                [&](const Tree::Node &node) {
+                    EpicKernel::Triangle_3 trb = _cgal_triangle(B, tb[node.idx]);
+                    if (trb.is_degenerate() || CGAL::do_intersect(tra, trb)) {
+                        intersect = true;
+                        return false;
+                    }
+                    return !intersect.load();
+                });
+        }
+    });
+
+    return intersect;
+}
+
+// Connected components of faces sharing vertices, returns the count of components.
+static size_t _cgal_components(const _EpicMesh &m, const _EpicTriangles &t, std::vector<size_t> &face_component)
+{
+    std::vector<size_t> parent(m.num_vertices());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    for (const auto &f : t)
+        for (size_t i = 1; i < 3; ++i)
+            parent[find(size_t(f[i]))] = find(size_t(f[0]));
+
+    std::vector<size_t> component(parent.size(), std::numeric_limits<size_t>::max());
+    size_t count = 0;
+    face_component.resize(t.size());
+    for (size_t i = 0; i < t.size(); ++i) {
+        size_t &c = component[find(size_t(t[i][0]))];
+        if (c == std::numeric_limits<size_t>::max())
+            c = count++;
+        face_component[i] = c;
+    }
+
+    return count;
+}
+
+// Classify each component of m by one of its vertices against the volume of other.
+static std::vector<bool> _cgal_components_inside(const _EpicMesh &m, const _EpicTriangles &t,
+                                                 const std::vector<size_t> &face_component,
+                                                 size_t components_count, const _EpicMesh &other)
+{
+    std::vector<bool> inside(components_count, false);
+    if (other.number_of_faces() == 0)
+        return inside;
+
+    std::vector<_EpicMesh::Vertex_index> representative(components_count, _EpicMesh::null_vertex());
+    for (size_t i = 0; i < t.size(); ++i)
+        if (representative[face_component[i]] == _EpicMesh::null_vertex())
+            representative[face_component[i]] = t[i][0];
+
+    CGAL::Side_of_triangle_mesh<_EpicMesh, EpicKernel> side(other);
+    for (size_t c = 0; c < components_count; ++c)
+        inside[c] = side(m.point(representative[c])) == CGAL::ON_BOUNDED_SIDE;
+
+    return inside;
+}
+
+static bool _cgal_append_components(const _EpicMesh &m, const _EpicTriangles &t,
+                                    const std::vector<size_t> &face_component,
+                                    const std::vector<bool> &keep, bool reverse, _EpicMesh &out)
+{
+    std::vector<_EpicMesh::Vertex_index> vertex_map(m.num_vertices(), _EpicMesh::null_vertex());
+    for (size_t i = 0; i < t.size(); ++i) {
+        if (!keep[face_component[i]])
+            continue;
+
+        std::array<_EpicMesh::Vertex_index, 3> f;
+        for (size_t j = 0; j < 3; ++j) {
+            _EpicMesh::Vertex_index &v = vertex_map[size_t(t[i][j])];
+            if (v == _EpicMesh::null_vertex())
+                v = out.add_vertex(m.point(t[i][j]));
+            f[j] = v;
+        }
+
+        if (reverse)
+            std::swap(f[1], f[2]);
+
+        if (out.add_face(f[0], f[1], f[2]) == _EpicMesh::null_face())
+            return false;
+    }
+
+    return true;
+}
+
+// Returns false if the surfaces of A and B intersect and the result has to be
+// computed by corefinement.
+static bool _cgal_disjoint_boolean(CGALMesh &A, CGALMesh &B, CGALMesh &R,
+                                   bool keep_a_inside, bool keep_b_inside, bool reverse_b)
+{
+    // Classifying the components as inside or outside is only valid for meshes bounding a volume.
+    if (!s_disjoint_fast_path || !CGAL::is_closed(A.m) || !CGAL::is_closed(B.m) ||
+        !CGALProc::does_bound_a_volume(A.m) || !CGALProc::does_bound_a_volume(B.m))
+        return false;
+
+    std::optional<_EpicTriangles> ta = _cgal_triangles(A.m);
+    std::optional<_EpicTriangles> tb = _cgal_triangles(B.m);
+    if (!ta || !tb || _cgal_surfaces_intersect(A.m, *ta, B.m, *tb))
+        return false;
+
+    std::vector<size_t> ca, cb;
+    size_t ca_count = _cgal_components(A.m, *ta, ca);
+    size_t cb_count = _cgal_components(B.m, *tb, cb);
+
+    std::vector<bool> keep_a = _cgal_components_inside(A.m, *ta, ca, ca_count, B.m);
+    std::vector<bool> keep_b = _cgal_components_inside(B.m, *tb, cb, cb_count, A.m);
+    for (size_t c = 0; c < ca_count; ++c)
+        keep_a[c] = keep_a[c] == keep_a_inside;
+    for (size_t c = 0; c < cb_count; ++c)
+        keep_b[c] = keep_b[c] == keep_b_inside;
+
+    R.m.clear();
+    return _cgal_append_components(A.m, *ta, ca, keep_a, false, R.m) &&
+           _cgal_append_components(B.m, *tb, cb, keep_b, reverse_b, R.m);
+}
+
 static bool _cgal_diff(CGALMesh &A, CGALMesh &B, CGALMesh &R)
 {
+    // A outside of B, B inside of A turned into cavities.
+    if (_cgal_disjoint_boolean(A, B, R, false, true, true))
+        return true;
+
+    R.m.clear();
     const auto &p = CGALParams::throw_on_self_intersection(true);
     return CGALProc::corefine_and_compute_difference(A.m, B.m, R.m, p, p);
 }
 
 static bool _cgal_union(CGALMesh &A, CGALMesh &B, CGALMesh &R)
 {
+    if (_cgal_disjoint_boolean(A, B, R, false, false, false))
+        return true;
+
+    R.m.clear();
     const auto &p = CGALParams::throw_on_self_intersection(true);
     return CGALProc::corefine_and_compute_union(A.m, B.m, R.m, p, p);
 }
 
 static bool _cgal_intersection(CGALMesh &A, CGALMesh &B, CGALMesh &R)
 {
+    if (_cgal_disjoint_boolean(A, B, R, true, true, false))
+        return true;
+
+    R.m.clear();
     const auto &p = CGALParams::throw_on_self_intersection(true);
     return CGALProc::corefine_and_compute_intersection(A.m, B.m, R.m, p, p);
 }
@@ -74,6 +74,10 @@ bool does_self_intersect(const CGALMesh &mesh);
 bool does_bound_a_volume(const CGALMesh &mesh);
 bool empty(const CGALMesh &mesh);
 
+// Booleans of meshes with disjoint surfaces are resolved without corefinement
+// by default. Disabling it is only useful to compare both paths in tests and benchmarks.
+void set_disjoint_fast_path(bool enable);
+
 }
 
 } // namespace MeshBoolean
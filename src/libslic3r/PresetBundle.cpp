@@ -27,6 +27,14 @@
 #include <boost/locale.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/set.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
 #include <LibBGCode/core/core.hpp>
 
 // Store the print/filament/printer presets into a "presets" subdirectory of the Slic3rPE config dir.
@@ -344,8 +352,268 @@ PresetsConfigSubstitutions PresetBundle::load_presets(AppConfig &config, Forward
     return substitutions;
 }
 
+// Path of a print / filament / printer preset .ini file in the user profile directory.
+static boost::filesystem::path preset_file_path(const PresetCollection &presets, const std::string &preset_name)
+{
+    auto file_name = boost::algorithm::iends_with(preset_name, ".ini") ? preset_name : preset_name + ".ini";
+    return (boost::filesystem::path(data_dir()) 
+#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
+        // Store the print/filament/printer presets into a "presets" directory.
+        / "presets" 
+#else
+        // Store the print/filament/printer presets at the same location as the upstream Slic3r.
+#endif
+        / presets.section_name() / file_name).make_preferred();
+}
+
+// Path of a physical printer .ini file in the user profile directory.
+static boost::filesystem::path physical_printer_file_path(const std::string &printer_name)
+{
+    auto file_name = boost::algorithm::iends_with(printer_name, ".ini") ? printer_name : printer_name + ".ini";
+    return (boost::filesystem::path(data_dir())
+#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
+        // Store the physical printers into a "presets" directory.
+        / "presets"
+#else
+        // Store the physical printers at the same location as the upstream Slic3r.
+#endif
+        / "physical_printer" / file_name).make_preferred();
+}
+
+// Binary snapshots of the flattened vendor config bundles, stored in data_dir()/cache/system_presets.
+// Parsing a vendor config bundle (read_ini, flattening of the inheritance, deserialization of the options)
+// is expensive, while its result only changes with the content of the vendor .ini file or with the build
+// of PrusaSlicer: the configs are stored by the serialization ordinals of their options, see PrintConfig.hpp.
+namespace system_presets_cache {
+
+// Increase whenever the layout of the snapshot changes.
+static constexpr const uint32_t VERSION = 3;
+
+static inline uint64_t fnv1a(uint64_t hash, const void *data, size_t len)
+{
+    for (const unsigned char *p = static_cast<const unsigned char*>(data), *end = p + len; p != end; ++ p)
+        hash = (hash ^ *p) * 0x100000001b3ull;
+    return hash;
+}
+static inline uint64_t fnv1a(uint64_t hash, const std::string &str) { return fnv1a(hash, str.data(), str.size() + 1); }
+static constexpr const uint64_t FNV1A_SEED = 0xcbf29ce484222325ull;
+
+// Snapshots written by another build may address the config options by different ordinals.
+// The default values are hashed as well, as they fill in the options missing in the vendor .ini file.
+static uint64_t build_stamp()
+{
+    static const uint64_t stamp = []() {
+        uint64_t hash = fnv1a(fnv1a(FNV1A_SEED, &VERSION, sizeof(VERSION)), std::string(SLIC3R_BUILD_ID));
+        for (const auto &[ordinal, def] : print_config_def.by_serialization_key_ordinal) {
+            hash = fnv1a(hash, &ordinal, sizeof(ordinal));
+            hash = fnv1a(hash, def->opt_key);
+            hash = fnv1a(hash, &def->type, sizeof(def->type));
+            if (def->enum_def)
+                for (const std::string &value : def->enum_def->values())
+                    hash = fnv1a(hash, value);
+            if (def->default_value)
+                hash = fnv1a(hash, def->default_value->serialize());
+        }
+        return hash;
+    }();
+    return stamp;
+}
+
+// Hash of the content of a vendor config bundle. Returns zero if the file could not be read.
+static uint64_t hash_file(const boost::filesystem::path &path)
+{
+    boost::nowide::ifstream ifs(path.string(), std::ios::binary);
+    if (! ifs)
+        return 0;
+    uint64_t          hash = FNV1A_SEED;
+    std::vector<char> buffer(1 << 16);
+    while (ifs) {
+        ifs.read(buffer.data(), buffer.size());
+        hash = fnv1a(hash, buffer.data(), size_t(ifs.gcount()));
+    }
+    return hash;
+}
+
+static boost::filesystem::path snapshot_path(const std::string &vendor_id)
+{
+    return (boost::filesystem::path(data_dir()) / "cache" / "system_presets" / (vendor_id + ".cereal")).make_preferred();
+}
+
+static inline std::array<PresetCollection*, 5> collections(PresetBundle &bundle)
+{
+    return { &bundle.prints, &bundle.sla_prints, &bundle.filaments, &bundle.sla_materials, &bundle.printers };
+}
+
+template<class Archive> static void serialize_obsolete_presets(Archive &archive, PresetBundle::ObsoletePresets &obsolete)
+{
+    archive(obsolete.prints, obsolete.sla_prints, obsolete.filaments, obsolete.sla_materials, obsolete.printers);
+}
+
+static void save_vendor(cereal::BinaryOutputArchive &archive, const VendorProfile &vendor)
+{
+    archive(vendor.name, vendor.id, vendor.config_version.to_string(), vendor.config_update_url, vendor.changelog_url,
+        vendor.repo_id, vendor.repo_prefix, vendor.templates_profile);
+    archive(vendor.models.size());
+    for (const VendorProfile::PrinterModel &model : vendor.models) {
+        archive(model.id, model.name, int(model.technology), model.family, model.default_materials, model.bed_model, model.bed_texture, model.thumbnail);
+        archive(model.variants.size());
+        for (const VendorProfile::PrinterVariant &variant : model.variants)
+            archive(variant.name);
+    }
+    archive(vendor.default_filaments, vendor.default_sla_materials);
+}
+
+static void load_vendor(cereal::BinaryInputArchive &archive, VendorProfile &vendor)
+{
+    std::string config_version;
+    archive(vendor.name, vendor.id, config_version, vendor.config_update_url, vendor.changelog_url,
+        vendor.repo_id, vendor.repo_prefix, vendor.templates_profile);
+    if (auto semver = Semver::parse(config_version); semver)
+        vendor.config_version = std::move(*semver);
+    else
+        throw Slic3r::RuntimeError("Invalid config_version");
+    size_t num_models;
+    archive(num_models);
+    vendor.models.assign(num_models, VendorProfile::PrinterModel());
+    for (VendorProfile::PrinterModel &model : vendor.models) {
+        int technology;
+        archive(model.id, model.name, technology, model.family, model.default_materials, model.bed_model, model.bed_texture, model.thumbnail);
+        model.technology = PrinterTechnology(technology);
+        size_t num_variants;
+        archive(num_variants);
+        model.variants.assign(num_variants, VendorProfile::PrinterVariant());
+        for (VendorProfile::PrinterVariant &variant : model.variants)
+            archive(variant.name);
+    }
+    archive(vendor.default_filaments, vendor.default_sla_materials);
+}
+
+// Enum options are loaded from a snapshot as generic enums, while load_configbundle() keeps the classes of the options
+// of the default config, such as the typed ConfigOptionEnum<T>. Restore them, so that a loaded bundle matches a parsed one.
+static void restore_option_classes(DynamicPrintConfig &config, const DynamicPrintConfig &defaults)
+{
+    for (const std::string &key : config.keys())
+        if (const ConfigOption *opt_default = defaults.option(key); opt_default != nullptr) {
+            const ConfigOption *opt = config.option(key);
+            if (typeid(*opt) != typeid(*opt_default)) {
+                ConfigOption *restored = opt_default->clone();
+                restored->set(opt);
+                config.set_key_value(key, restored);
+            }
+        }
+}
+
+// Load a vendor bundle from its snapshot. Returns false if the snapshot is missing, stale or damaged.
+static bool load(PresetBundle &bundle, const std::string &vendor_id, uint64_t ini_hash)
+{
+    const boost::filesystem::path path = snapshot_path(vendor_id);
+    if (ini_hash == 0 || ! boost::filesystem::exists(path))
+        return false;
+    try {
+        boost::nowide::ifstream     file(path.string(), std::ios::binary);
+        cereal::BinaryInputArchive  archive(file);
+        uint64_t                    stamp, hash;
+        archive(stamp, hash);
+        if (stamp != build_stamp() || hash != ini_hash)
+            return false;
+
+        bundle.reset(false);
+        VendorProfile vp;
+        load_vendor(archive, vp);
+        const VendorProfile *vendor_profile = &bundle.vendors.insert({ vp.id, std::move(vp) }).first->second;
+        for (PresetCollection *presets : collections(bundle)) {
+            size_t num_presets;
+            archive(num_presets);
+            for (size_t i = 0; i < num_presets; ++ i) {
+                std::string              name;
+                std::string              alias;
+                std::vector<std::string> renamed_from;
+                DynamicPrintConfig       config;
+                archive(name, alias, renamed_from, config);
+                restore_option_classes(config, presets->default_preset_for(config).config);
+                Preset &loaded = presets->load_preset(preset_file_path(*presets, name).string(), name, std::move(config), false);
+                loaded.is_system    = true;
+                loaded.vendor       = vendor_profile;
+                loaded.alias        = std::move(alias);
+                loaded.renamed_from = std::move(renamed_from);
+            }
+        }
+        serialize_obsolete_presets(archive, bundle.obsolete_presets);
+        // Physical printers of the vendor config bundle. PresetBundle::reset() does not release them,
+        // therefore they are only loaded into the bundle once the whole snapshot has been read.
+        size_t num_physical_printers;
+        archive(num_physical_printers);
+        std::vector<std::pair<std::string, DynamicPrintConfig>> physical_printers(num_physical_printers);
+        for (auto &[name, config] : physical_printers) {
+            archive(name, config);
+            restore_option_classes(config, bundle.physical_printers.default_config());
+        }
+        for (auto &[name, config] : physical_printers)
+            bundle.physical_printers.load_printer(physical_printer_file_path(name).string(), name, std::move(config), false);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed loading a snapshot of the system presets " << path.string() << ": " << ex.what();
+        bundle.reset(false);
+        return false;
+    }
+    return true;
+}
+
+// Store a vendor bundle loaded by PresetBundle::load_configbundle() into its snapshot.
+static void save(PresetBundle &bundle, const std::string &vendor_id, uint64_t ini_hash)
+{
+    if (ini_hash == 0 || bundle.vendors.size() != 1)
+        return;
+    auto serializable = [](const DynamicPrintConfig &config) {
+        for (const std::string &key : config.keys())
+            if (const ConfigOptionDef *optdef = print_config_def.get(key); optdef == nullptr || optdef->serialization_key_ordinal == 0)
+                return false;
+        return true;
+    };
+    for (PresetCollection *presets : collections(bundle))
+        for (const Preset &preset : *presets)
+            if (! serializable(preset.config))
+                // Not serializable, the bundle will be parsed on each start.
+                return;
+    for (const PhysicalPrinter &printer : bundle.physical_printers)
+        if (! serializable(printer.config))
+            return;
+
+    const boost::filesystem::path path     = snapshot_path(vendor_id);
+    // Write into a temporary file first, so that concurrently starting instances never read an incomplete snapshot.
+    const boost::filesystem::path path_tmp = path.string() + boost::filesystem::unique_path(".%%%%-%%%%.tmp").string();
+    try {
+        boost::filesystem::create_directories(path.parent_path());
+        {
+            boost::nowide::ofstream     file(path_tmp.string(), std::ios::binary);
+            cereal::BinaryOutputArchive archive(file);
+            archive(build_stamp(), ini_hash);
+            save_vendor(archive, bundle.vendors.begin()->second);
+            for (PresetCollection *presets : collections(bundle)) {
+                archive(size_t(std::distance(presets->begin(), presets->end())));
+                for (const Preset &preset : *presets)
+                    archive(preset.name, preset.alias, preset.renamed_from, preset.config);
+            }
+            serialize_obsolete_presets(archive, bundle.obsolete_presets);
+            archive(size_t(std::distance(bundle.physical_printers.begin(), bundle.physical_printers.end())));
+            for (const PhysicalPrinter &printer : bundle.physical_printers)
+                archive(printer.name, printer.config);
+            if (! file)
+                throw Slic3r::RuntimeError("Write error");
+        }
+        boost::filesystem::rename(path_tmp, path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed saving a snapshot of the system presets " << path.string() << ": " << ex.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_tmp, ec);
+    }
+}
+
+} // namespace system_presets_cache
+
 // Load system presets into this PresetBundle.
 // For each vendor, there will be a single PresetBundle loaded.
+// The vendor bundles are loaded in parallel, either from their snapshots in the cache, or by parsing the vendor .ini files.
+// Then they are merged into this PresetBundle in the order of the vendor .ini files.
 std::pair<PresetsConfigSubstitutions, std::string> PresetBundle::load_system_presets(ForwardCompatibilitySubstitutionRule compatibility_rule)
 {
     if (compatibility_rule == ForwardCompatibilitySubstitutionRule::EnableSystemSilent)
@@ -357,44 +625,59 @@ std::pair<PresetsConfigSubstitutions, std::string> PresetBundle::load_system_pre
 
     // Here the vendor specific read only Config Bundles are stored.
     boost::filesystem::path     dir = (boost::filesystem::path(data_dir()) / "vendor").make_preferred();
-    PresetsConfigSubstitutions  substitutions;
-    std::string                 errors_cummulative;
-    bool                        first = true;
+    std::vector<boost::filesystem::path> paths;
     for (auto &dir_entry : boost::filesystem::directory_iterator(dir))
-        if (Slic3r::is_ini_file(dir_entry)) {
-            std::string name = dir_entry.path().filename().string();
-            // Remove the .ini suffix.
-            name.erase(name.size() - 4);
+        if (Slic3r::is_ini_file(dir_entry))
+            paths.emplace_back(dir_entry.path());
+
+    struct VendorBundle {
+        PresetBundle                bundle;
+        PresetsConfigSubstitutions  substitutions;
+        std::string                 error;
+    };
+    std::vector<VendorBundle> vendor_bundles(paths.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size()), [&paths, &vendor_bundles, compatibility_rule](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            VendorBundle      &vb        = vendor_bundles[i];
+            // Vendor ID is the name of the .ini file without the suffix.
+            const std::string  vendor_id = paths[i].stem().string();
             try {
-                // Load the config bundle, flatten it.
-                if (first) {
-                    // Reset this PresetBundle and load the first vendor config.
-                    append(substitutions, this->load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
-                    first = false;
-                } else {
-                    // Load the other vendor configs, merge them with this PresetBundle.
-                    // Report duplicate profiles.
-                    PresetBundle other;
-                    append(substitutions, other.load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
-                    std::vector<std::string> duplicates = this->merge_presets(std::move(other));
-                    if (! duplicates.empty()) {
-                        errors_cummulative += "Vendor configuration file " + name + " contains the following presets with names used by other vendors: ";
-                        for (size_t i = 0; i < duplicates.size(); ++ i) {
-                            if (i > 0)
-                                errors_cummulative += ", ";
-                            errors_cummulative += duplicates[i];
-                        }
-                    }
+                const uint64_t ini_hash = system_presets_cache::hash_file(paths[i]);
+                if (! system_presets_cache::load(vb.bundle, vendor_id, ini_hash)) {
+                    // Load the config bundle, flatten it.
+                    vb.substitutions = vb.bundle.load_configbundle(paths[i].string(), PresetBundle::LoadSystem, compatibility_rule).first;
+                    // Snapshot only a bundle loaded without substitutions, which is then valid for any compatibility_rule.
+                    if (vb.substitutions.empty())
+                        system_presets_cache::save(vb.bundle, vendor_id, ini_hash);
                 }
             } catch (const std::runtime_error &err) {
-                errors_cummulative += err.what();
-                errors_cummulative += "\n";
+                vb.error = err.what();
             }
         }
-    if (first) {
-		// No config bundle loaded, reset.
-		this->reset(false);
-	}
+    });
+
+    // Reset this PresetBundle, merge the vendor configs. Report duplicate profiles.
+    this->reset(false);
+    PresetsConfigSubstitutions  substitutions;
+    std::string                 errors_cummulative;
+    for (size_t i = 0; i < paths.size(); ++ i) {
+        VendorBundle &vb = vendor_bundles[i];
+        if (! vb.error.empty()) {
+            errors_cummulative += vb.error;
+            errors_cummulative += "\n";
+            continue;
+        }
+        append(substitutions, std::move(vb.substitutions));
+        std::vector<std::string> duplicates = this->merge_presets(std::move(vb.bundle));
+        if (! duplicates.empty()) {
+            errors_cummulative += "Vendor configuration file " + paths[i].stem().string() + " contains the following presets with names used by other vendors: ";
+            for (size_t j = 0; j < duplicates.size(); ++ j) {
+                if (j > 0)
+                    errors_cummulative += ", ";
+                errors_cummulative += duplicates[j];
+            }
+        }
+    }
 
 	this->update_system_maps();
     return std::make_pair(std::move(substitutions), errors_cummulative);
@@ -418,6 +701,12 @@ std::vector<std::string> PresetBundle::merge_presets(PresetBundle &&other)
 	append(duplicate_prints, std::move(duplicate_filaments));
     append(duplicate_prints, std::move(duplicate_sla_materials));
     append(duplicate_prints, std::move(duplicate_printers));
+    // Physical printers defined by a vendor config bundle. The first one loaded wins, as in load_configbundle().
+    for (PhysicalPrinter &printer : other.physical_printers)
+        if (this->physical_printers.find_printer(printer.name, false) == nullptr)
+            this->physical_printers.load_printer(printer.file, printer.name, std::move(printer.config), false);
+        else
+            duplicate_prints.emplace_back(printer.name);
     return duplicate_prints;
 }
 
@@ -1631,18 +1920,8 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 					BOOST_LOG_TRIVIAL(trace) << "A new " << presets->name() << " preset \"" << preset_name << "\" was imported from user Config Bundle \"" << path << "\"";
                 }
             }
-            // Decide a full path to this .ini file.
-            auto file_name = boost::algorithm::iends_with(preset_name, ".ini") ? preset_name : preset_name + ".ini";
-            auto file_path = (boost::filesystem::path(data_dir()) 
-#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
-                // Store the print/filament/printer presets into a "presets" directory.
-                / "presets" 
-#else
-                // Store the print/filament/printer presets at the same location as the upstream Slic3r.
-#endif
-                / presets->section_name() / file_name).make_preferred();
             // Load the preset into the list of presets, save it to disk.
-            Preset &loaded = presets->load_preset(file_path.string(), preset_name, std::move(config), false);
+            Preset &loaded = presets->load_preset(preset_file_path(*presets, preset_name).string(), preset_name, std::move(config), false);
             if (flags.has(LoadConfigBundleAttribute::SaveImported))
                 loaded.save();
             if (flags.has(LoadConfigBundleAttribute::LoadSystem)) {
@@ -1699,18 +1978,8 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
                 continue;
             }
 
-            // Decide a full path to this .ini file.
-            auto file_name = boost::algorithm::iends_with(ph_printer_name, ".ini") ? ph_printer_name : ph_printer_name + ".ini";
-            auto file_path = (boost::filesystem::path(data_dir())
-#ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
-                // Store the physical printers into a "presets" directory.
-                / "presets"
-#else
-                // Store the physical printers at the same location as the upstream Slic3r.
-#endif
-                / "physical_printer" / file_name).make_preferred();
             // Load the preset into the list of presets, save it to disk.
-            ph_printers->load_printer(file_path.string(), ph_printer_name, std::move(config), false, flags.has(LoadConfigBundleAttribute::SaveImported));
+            ph_printers->load_printer(physical_printer_file_path(ph_printer_name).string(), ph_printer_name, std::move(config), false, flags.has(LoadConfigBundleAttribute::SaveImported));
             if (! substitution_context.empty())
                 substitutions.push_back({
                     ph_printer_name, Preset::TYPE_PHYSICAL_PRINTER, PresetConfigSubstitutions::Source::ConfigBundle, 
@@ -68,6 +68,7 @@ void Print::clear()
 	m_objects.clear();
     m_print_regions.clear();
     m_model.clear_objects();
+    m_layer_spill.reset();
 }
 
 // Called by Print::apply().
@@ -890,6 +891,9 @@ void Print::process()
 
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
 
+    if (m_layer_spill)
+        this->reload_spilled_layers();
+
     tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
         for (size_t idx = range.begin(); idx < range.end(); ++idx) {
             m_objects[idx]->make_perimeters();
@@ -898,9 +902,25 @@ void Print::process()
         }
     }, tbb::simple_partitioner());
 
-    // The following step writes to m_shared_regions, it should not run in parallel.
-    for (PrintObject *obj : m_objects)
-        obj->generate_support_spots();
+    // The following step writes to m_shared_regions. PrintObjects sharing the same PrintObjectRegions
+    // are processed by a single task one after another (only the first one will actually search for
+    // the support spots), thus each task publishes its results into its own PrintObjectRegions only.
+    {
+        std::vector<std::vector<PrintObject*>> objects_by_shared_regions;
+        for (PrintObject *obj : m_objects) {
+            auto it = std::find_if(objects_by_shared_regions.begin(), objects_by_shared_regions.end(),
+                [obj](const std::vector<PrintObject*> &group) { return group.front()->shared_regions() == obj->shared_regions(); });
+            if (it == objects_by_shared_regions.end())
+                objects_by_shared_regions.push_back({ obj });
+            else
+                it->emplace_back(obj);
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, objects_by_shared_regions.size(), 1), [&objects_by_shared_regions](const tbb::blocked_range<size_t> &range) {
+            for (size_t idx = range.begin(); idx < range.end(); ++ idx)
+                for (PrintObject *obj : objects_by_shared_regions[idx])
+                    obj->generate_support_spots();
+        }, tbb::simple_partitioner());
+    }
     // check data from previous step, format the error message(s) and send alert to ui
     // this also has to be done sequentially.
     alert_when_supports_needed();
@@ -977,9 +997,61 @@ void Print::process()
 
     m_sequential_collision_detected =  config().complete_objects ? check_seq_conflict(model(), config()) : std::nullopt;
 
+    if (m_memory_budget > 0)
+        this->spill_layers();
+
     BOOST_LOG_TRIVIAL(info) << "Slicing process finished." << log_memory_info();
 }
 
+void Print::reload_spilled_layers()
+{
+    for (PrintObject *object : m_objects) {
+        bool reprocess = false;
+        for (int step = 0; step < int(posCount) && ! reprocess; ++ step)
+            reprocess = ! object->is_step_done(PrintObjectStep(step));
+        if (reprocess)
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, object->m_layers.size()), [this, object](const tbb::blocked_range<size_t> &range) {
+                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                    m_layer_spill->reload(*object->m_layers[layer_idx]);
+            });
+        else if (! this->is_step_done(psSkirtBrim) && ! object->m_layers.empty())
+            // The brim is generated from the slices of the first layer.
+            m_layer_spill->reload(*object->m_layers.front());
+    }
+    BOOST_LOG_TRIVIAL(info) << "Spilled layers read back, " << m_layer_spill->bytes_reloaded() << " bytes read in total";
+}
+
+void Print::spill_layers()
+{
+    std::vector<size_t> footprints;
+    size_t              total = 0;
+    for (const PrintObject *object : m_objects)
+        for (const Layer *layer : object->m_layers) {
+            footprints.emplace_back(layer->spilled() ? 0 : LayerSpillFile::footprint(*layer));
+            total += footprints.back();
+        }
+    if (total <= m_memory_budget)
+        return;
+
+    if (! m_layer_spill)
+        m_layer_spill = std::make_unique<LayerSpillFile>();
+    const size_t total_before = total;
+    size_t       idx          = 0;
+    size_t       num_spilled  = 0;
+    for (PrintObject *object : m_objects)
+        for (Layer *layer : object->m_layers) {
+            if (total > m_memory_budget && footprints[idx] > 0) {
+                this->throw_if_canceled();
+                m_layer_spill->spill(*layer);
+                total -= footprints[idx];
+                ++ num_spilled;
+            }
+            ++ idx;
+        }
+    BOOST_LOG_TRIVIAL(info) << "Memory budget " << m_memory_budget << " bytes exceeded by the layer slices (" << total_before << " bytes), " <<
+        num_spilled << " layers written out, " << m_layer_spill->bytes_spilled() << " bytes spilled in total";
+}
+
 // G-code export process, running at a background thread.
 // The export_gcode may die for various reasons (fails to process output_filename_format,
 // write error into the G-code, cannot execute post-processing scripts).
@@ -1488,33 +1560,64 @@ void Print::_make_wipe_tower()
     // Lets go through the wipe tower layers and determine pairs of extruder changes for each
     // to pass to wipe_tower (so that it can use it for planning the layout of the tower)
     {
+        struct ToolChange {
+            unsigned int old_tool;
+            unsigned int new_tool;
+            // Total volume to wipe after this toolchange, then the volume left for the wipe tower.
+            float        volume_to_wipe;
+        };
+        struct WipeTowerLayer {
+            LayerTools              *layer_tools;
+            // Extruder active at the start of the layer.
+            unsigned int             start_tool;
+            std::vector<ToolChange>  tool_changes;
+        };
+        std::vector<WipeTowerLayer> wipe_tower_layers;
+        // The tool changes only depend on the extruders of the preceding layers, collect them first.
         unsigned int current_extruder_id = m_wipe_tower_data.tool_ordering.all_extruders().back();
         for (auto &layer_tools : m_wipe_tower_data.tool_ordering.layer_tools()) { // for all layers
             if (!layer_tools.has_wipe_tower) continue;
-            wipe_tower.plan_toolchange((float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height, current_extruder_id, current_extruder_id, false);
+            WipeTowerLayer &wipe_tower_layer = wipe_tower_layers.emplace_back(WipeTowerLayer{ &layer_tools, current_extruder_id, {} });
             for (const auto extruder_id : layer_tools.extruders) {
                 const bool first_layer{&layer_tools == &m_wipe_tower_data.tool_ordering.front()};
                 const unsigned last_extruder_id{m_wipe_tower_data.tool_ordering.all_extruders().back()};
                 if (is_toolchange_required(first_layer, last_extruder_id, extruder_id, current_extruder_id)) {
-                    float volume_to_wipe = wipe_volumes[current_extruder_id][extruder_id];             // total volume to wipe after this toolchange
+                    wipe_tower_layer.tool_changes.push_back({ current_extruder_id, extruder_id, wipe_volumes[current_extruder_id][extruder_id] });
+                    current_extruder_id = extruder_id;
+                }
+            }
+            if (&layer_tools == &m_wipe_tower_data.tool_ordering.back() || (&layer_tools + 1)->wipe_tower_partitions == 0)
+                break;
+        }
+
+        // Assigning infills / objects for wiping only touches the WipingExtrusions of its own layer, thus the layers are processed in parallel.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, wipe_tower_layers.size()), [this, &wipe_tower_layers](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                this->throw_if_canceled();
+                WipeTowerLayer &wipe_tower_layer = wipe_tower_layers[layer_idx];
+                LayerTools     &layer_tools      = *wipe_tower_layer.layer_tools;
+                for (ToolChange &tool_change : wipe_tower_layer.tool_changes) {
                     // Not all of that can be used for infill purging:
-                    volume_to_wipe -= (float)m_config.filament_minimal_purge_on_wipe_tower.get_at(extruder_id);
+                    tool_change.volume_to_wipe -= (float)m_config.filament_minimal_purge_on_wipe_tower.get_at(tool_change.new_tool);
 
                     // try to assign some infills/objects for the wiping:
-                    volume_to_wipe = layer_tools.wiping_extrusions_nonconst().mark_wiping_extrusions(*this, layer_tools, current_extruder_id, extruder_id, volume_to_wipe);
+                    tool_change.volume_to_wipe = layer_tools.wiping_extrusions_nonconst().mark_wiping_extrusions(*this, layer_tools, tool_change.old_tool, tool_change.new_tool, tool_change.volume_to_wipe);
 
                     // add back the minimal amount toforce on the wipe tower:
-                    volume_to_wipe += (float)m_config.filament_minimal_purge_on_wipe_tower.get_at(extruder_id);
-
-                    // request a toolchange at the wipe tower with at least volume_to_wipe purging amount
-                    wipe_tower.plan_toolchange((float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height,
-                                               current_extruder_id, extruder_id, volume_to_wipe);
-                    current_extruder_id = extruder_id;
+                    tool_change.volume_to_wipe += (float)m_config.filament_minimal_purge_on_wipe_tower.get_at(tool_change.new_tool);
                 }
+                layer_tools.wiping_extrusions_nonconst().ensure_perimeters_infills_order(*this, layer_tools);
             }
-            layer_tools.wiping_extrusions_nonconst().ensure_perimeters_infills_order(*this, layer_tools);
-            if (&layer_tools == &m_wipe_tower_data.tool_ordering.back() || (&layer_tools + 1)->wipe_tower_partitions == 0)
-                break;
+        });
+        this->throw_if_canceled();
+
+        for (const WipeTowerLayer &wipe_tower_layer : wipe_tower_layers) {
+            const LayerTools &layer_tools = *wipe_tower_layer.layer_tools;
+            wipe_tower.plan_toolchange((float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height, wipe_tower_layer.start_tool, wipe_tower_layer.start_tool, false);
+            // request a toolchange at the wipe tower with at least volume_to_wipe purging amount
+            for (const ToolChange &tool_change : wipe_tower_layer.tool_changes)
+                wipe_tower.plan_toolchange((float)layer_tools.print_z, (float)layer_tools.wipe_tower_layer_height,
+                                           tool_change.old_tool, tool_change.new_tool, tool_change.volume_to_wipe);
         }
     }
 
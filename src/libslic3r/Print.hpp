@@ -28,6 +28,7 @@
 #include "BoundingBox.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "Flow.hpp"
+#include "LayerSpill.hpp"
 #include "Point.hpp"
 #include "Slicing.hpp"
 #include "SupportSpotsGenerator.hpp"
@@ -36,6 +37,8 @@
 #include "libslic3r/GCode/WipeTower.hpp"
 #include "libslic3r/GCode/ThumbnailData.hpp"
 #include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/GCode/ModelVisibility.hpp"
+#include "libslic3r/GCode/SeamPainting.hpp"
 #include "MultiMaterialSegmentation.hpp"
 
 #include "libslic3r.h"
@@ -286,6 +289,10 @@ public:
     Transform3d                  trafo_centered() const 
         { Transform3d t = this->trafo(); t.pretranslate(Vec3d(- unscale<double>(m_center_offset.x()), - unscale<double>(m_center_offset.y()), 0)); return t; }
     const PrintInstances&        instances() const      { return m_instances; }
+    // Mesh visibility used by the aligned seam placer and the AABB trees over the seam painting. They are validated
+    // against the meshes and transformation on each access, thus they survive invalidation of the G-code export step.
+    ModelInfo::VisibilityCache&         seam_visibility_cache() const { return m_seam_visibility_cache; }
+    Seams::ModelInfo::PaintingCache&    seam_painting_cache() const { return m_seam_painting_cache; }
 
     // Whoever will get a non-const pointer to PrintObject will be able to modify its layers.
     LayerPtrs&                   layers()               { return m_layers; }
@@ -454,6 +461,9 @@ private:
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
+
+    mutable ModelInfo::VisibilityCache      m_seam_visibility_cache;
+    mutable Seams::ModelInfo::PaintingCache m_seam_painting_cache;
 };
 
 
@@ -688,6 +698,14 @@ public:
     const PrintRegion&          get_print_region(size_t idx) const  { return *m_print_regions[idx]; }
     const ToolOrdering&         get_tool_ordering() const { return m_wipe_tower_data.tool_ordering; }
 
+    // Limit of memory held by the slices and fill surfaces of finished layers, which are only needed by the G-code export
+    // and for reprocessing the layers. Above the limit, the data is written out into a temporary file
+    // and read back when needed. Zero means no limit.
+    void                        set_memory_budget(size_t bytes) { m_memory_budget = bytes; }
+    size_t                      memory_budget() const { return m_memory_budget; }
+    // Null if no layer was written out yet.
+    LayerSpillFile*             layer_spill() const { return m_layer_spill.get(); }
+
     // Returns if all used filaments have same shrinkage compensations.
     bool has_same_shrinkage_compensations() const;
 
@@ -705,6 +723,9 @@ private:
     void                _make_wipe_tower();
     void                finalize_first_layer_convex_hull();
     void                alert_when_supports_needed();
+    // Read back the spilled layers of objects to be processed again, write out layers above the memory budget.
+    void                reload_spilled_layers();
+    void                spill_layers();
 
     // Islands of objects and their supports extruded at the 1st layer.
     Polygons            first_layer_islands() const;
@@ -741,6 +762,9 @@ private:
     // Estimated print time, filament consumed.
     PrintStatistics                         m_print_statistics;
 
+    size_t                                  m_memory_budget { 0 };
+    std::unique_ptr<LayerSpillFile>         m_layer_spill;
+
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCodeGenerator;
     // To allow GCodeProcessor to emit warnings.
@@ -278,7 +278,8 @@ static t_config_option_keys full_print_config_diffs(const DynamicPrintConfig &cu
     for (const t_config_option_key &opt_key : new_full_config.keys()) {
         const ConfigOption *opt_old = current_full_config.option(opt_key);
         const ConfigOption *opt_new = new_full_config.option(opt_key);
-        if (opt_old == nullptr || *opt_new != *opt_old)
+        // The options are shared if new_full_config was derived from current_full_config.
+        if (opt_old == nullptr || (opt_new != opt_old && *opt_new != *opt_old))
             full_config_diff.emplace_back(opt_key);
     }
     return full_config_diff;
@@ -5907,6 +5907,13 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("Sets the maximum number of threads the slicing process will use. If not defined, it will be decided automatically.");
     def->min = 1;
 
+    def = this->add("memory_budget", coInt);
+    def->label = L("Memory budget");
+    def->tooltip = L("Limits the memory held by the slices of the finished layers (in MB). Slices above the limit are written "
+        "into a temporary file and read back while exporting G-code. If not defined, all the slices are kept in memory.");
+    def->sidetext = L("MB");
+    def->min = 1;
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
@@ -432,8 +432,13 @@ void PrintObject::prepare_infill()
 
 void PrintObject::clear_fills()
 {
-    for (Layer *layer : m_layers)
-        layer->clear_fills();
+    // Releasing millions of extrusion entities is expensive, release them in parallel.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, m_layers.size()),
+        [this](const tbb::blocked_range<size_t>& range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                m_layers[layer_idx]->clear_fills();
+        });
 }
 
 void PrintObject::infill()
@@ -6,13 +6,17 @@
 
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_invoke.h>
+#include <oneapi/tbb/task_arena.h>
 #include <tuple>
 #include <optional>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <utility>
 #include <vector>
 #include <cassert>
@@ -132,7 +136,8 @@ namespace QuadricEdgeCollapse {
     double vertex_error(const SymMat &q, const Vec3d &vertex);
     SymMat create_quadric(const Triangle &t, const Vec3d& n, const Vertices &vertices);
     std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn,
+         const std::vector<SymMat> *vertex_quadrics = nullptr);
     std::optional<uint32_t> find_triangle_index1(uint32_t vi, const VertexInfo& v_info,
         uint32_t ti, const EdgeInfos& e_infos, const Indices& indices);
     void reorder_edges(EdgeInfos &e_infos, const VertexInfo &v_info, uint32_t ti0, uint32_t ti1);
@@ -150,6 +155,16 @@ namespace QuadricEdgeCollapse {
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
     void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    // collapse edges until triangle_count or maximal_error is reached, edges touching a locked vertex stay,
+    // deleted triangles are only marked in t_infos, return error of the last collapsed edge
+    float collapse_edges(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+        const std::vector<bool> *locked, TriangleInfos &t_infos, VertexInfos &v_infos, EdgeInfos &e_infos,
+        const Errors &errors, ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
+    // init, collapse edges and compact, vertex quadrics could be given from previous simplification
+    float simplify(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+        const std::vector<SymMat> *vertex_quadrics, ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
+    // split triangles into 2^depth spatially coherent parts of the same size
+    std::vector<std::vector<uint32_t>> create_partitions(const indexed_triangle_set &its, int depth);
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -169,6 +184,10 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // partitioned simplification
+    const int    status_partitions_size = 80; // in percents, rest is for the final pass over seams
+    const size_t min_partition_triangle_count = 100000;
+    const int    partitions_per_thread = 4;
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -187,6 +206,231 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = simplify(its, triangle_count, maximal_error, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_partitioned(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn,
+    size_t                    partition_triangle_count)
+{
+    if (partition_triangle_count == 0)
+        partition_triangle_count = std::max(min_partition_triangle_count,
+            its.indices.size() / (partitions_per_thread * tbb::this_task_arena::max_concurrency()));
+    // small mesh is not worth to split
+    if (its.indices.size() < 2 * partition_triangle_count) {
+        its_quadric_edge_collapse(its, triangle_count, max_error, throw_on_cancel, status_fn);
+        return;
+    }
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    int depth = 0;
+    while ((its.indices.size() >> depth) > partition_triangle_count) ++depth;
+    std::vector<std::vector<uint32_t>> partitions = create_partitions(its, depth);
+    throw_on_cancel();
+
+    // vertices used by more partitions are locked, seams are simplified by the final pass
+    const uint32_t shared_vertex = std::numeric_limits<uint32_t>::max();
+    const uint32_t unused_vertex = shared_vertex - 1;
+    std::vector<uint32_t> vertex_partition(its.vertices.size(), unused_vertex);
+    for (uint32_t pi = 0; pi < partitions.size(); ++pi)
+        for (uint32_t ti : partitions[pi])
+            for (size_t i = 0; i < 3; ++i) {
+                uint32_t &vp = vertex_partition[its.indices[ti][i]];
+                if (vp == unused_vertex) vp = pi;
+                else if (vp != pi) vp = shared_vertex;
+            }
+    // shared vertices are stored first in the result
+    std::vector<uint32_t> shared_vertex_index(its.vertices.size(), 0);
+    uint32_t shared_count = 0;
+    for (uint32_t vi = 0; vi < its.vertices.size(); ++vi)
+        if (vertex_partition[vi] == shared_vertex)
+            shared_vertex_index[vi] = shared_count++;
+
+    struct Part {
+        indexed_triangle_set its;   // simplified part, indices to local vertices
+        std::vector<bool> locked;   // local vertex is shared with other part
+        std::vector<SymMat> quadrics; // sum quadric of local vertex to continue in the final pass
+        std::vector<uint32_t> map;  // local vertex -> shared vertex or index of used inner vertex
+        uint32_t inner_count = 0;   // count of used inner vertices
+        float error = 0.f;          // last collapsed error
+    };
+    std::vector<Part> parts(partitions.size());
+    std::atomic<size_t> finished_parts{0};
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, parts.size(), 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t pi = range.begin(); pi < range.end(); ++pi) {
+            Part &part = parts[pi];
+            std::vector<uint32_t> &part_tis = partitions[pi];
+            // local to global vertex index, sorted
+            std::vector<uint32_t> vertices;
+            vertices.reserve(3 * part_tis.size());
+            for (uint32_t ti : part_tis)
+                for (size_t i = 0; i < 3; ++i) vertices.push_back(its.indices[ti][i]);
+            std::sort(vertices.begin(), vertices.end());
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+            part.its.vertices.reserve(vertices.size());
+            part.locked.reserve(vertices.size());
+            for (uint32_t vi : vertices) {
+                part.its.vertices.push_back(its.vertices[vi]);
+                part.locked.push_back(vertex_partition[vi] == shared_vertex);
+            }
+            part.its.indices.reserve(part_tis.size());
+            for (uint32_t ti : part_tis) {
+                Triangle t;
+                for (size_t i = 0; i < 3; ++i)
+                    t[i] = std::lower_bound(vertices.begin(), vertices.end(), uint32_t(its.indices[ti][i])) - vertices.begin();
+                part.its.indices.push_back(t);
+            }
+            part_tis = {}; // free memory
+
+            // same ratio of reduction for each part, triangles around locked vertices are left for the final pass
+            size_t seam_count = std::count_if(part.its.indices.begin(), part.its.indices.end(), [&part](const Triangle &t) {
+                return part.locked[t[0]] || part.locked[t[1]] || part.locked[t[2]];
+            });
+            uint32_t part_triangle_count = static_cast<uint32_t>(seam_count +
+                uint64_t(triangle_count) * (part.its.indices.size() - seam_count) / its.indices.size());
+            ThrowOnCancel part_throw_on_cancel = throw_on_cancel;
+            StatusFn      part_status_fn       = [](int) {};
+            TriangleInfos t_infos;
+            VertexInfos   v_infos;
+            EdgeInfos     e_infos;
+            Errors        errors;
+            std::tie(t_infos, v_infos, e_infos, errors) = init(part.its, part_throw_on_cancel, part_status_fn);
+            part.error = collapse_edges(part.its, part_triangle_count, maximal_error, &part.locked,
+                t_infos, v_infos, e_infos, errors, part_throw_on_cancel, part_status_fn);
+
+            // remove deleted triangles and number used inner vertices
+            uint32_t ti_new = 0;
+            for (uint32_t ti = 0; ti < t_infos.size(); ++ti)
+                if (!t_infos[ti].is_deleted())
+                    part.its.indices[ti_new++] = part.its.indices[ti];
+            part.its.indices.erase(part.its.indices.begin() + ti_new, part.its.indices.end());
+            std::vector<bool> used(vertices.size(), false);
+            for (const Triangle &t : part.its.indices)
+                for (size_t i = 0; i < 3; ++i) used[t[i]] = true;
+            part.map.assign(vertices.size(), unused_vertex);
+            part.quadrics.resize(vertices.size());
+            for (uint32_t vi = 0; vi < vertices.size(); ++vi) {
+                if (part.locked[vi])
+                    part.map[vi] = shared_vertex_index[vertices[vi]];
+                else if (used[vi])
+                    part.map[vi] = part.inner_count++;
+                part.quadrics[vi] = v_infos[vi].q;
+            }
+
+            status_fn(static_cast<int>(++finished_parts * status_partitions_size / parts.size()));
+        }
+    }); // END parallel for
+    throw_on_cancel();
+
+    // merge parts, locked vertices are not moved
+    std::vector<uint32_t> vertex_offsets(parts.size()), triangle_offsets(parts.size());
+    uint32_t vertex_count = shared_count, result_triangle_count = 0;
+    for (size_t pi = 0; pi < parts.size(); ++pi) {
+        vertex_offsets[pi]   = vertex_count;
+        triangle_offsets[pi] = result_triangle_count;
+        vertex_count += parts[pi].inner_count;
+        result_triangle_count += parts[pi].its.indices.size();
+    }
+    indexed_triangle_set result;
+    result.vertices.resize(vertex_count);
+    result.indices.resize(result_triangle_count);
+    std::vector<SymMat> quadrics(vertex_count);
+    for (uint32_t vi = 0; vi < its.vertices.size(); ++vi)
+        if (vertex_partition[vi] == shared_vertex)
+            result.vertices[shared_vertex_index[vi]] = its.vertices[vi];
+    // quadric of shared vertex is sum of its quadrics from all parts
+    for (const Part &part : parts)
+        for (uint32_t vi = 0; vi < part.its.vertices.size(); ++vi)
+            if (part.locked[vi])
+                quadrics[part.map[vi]] += part.quadrics[vi];
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, parts.size(), 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t pi = range.begin(); pi < range.end(); ++pi) {
+            const Part &part = parts[pi];
+            auto result_vertex = [&](uint32_t vi) {
+                return part.locked[vi] ? part.map[vi] : vertex_offsets[pi] + part.map[vi];
+            };
+            for (uint32_t vi = 0; vi < part.its.vertices.size(); ++vi)
+                if (!part.locked[vi] && part.map[vi] != unused_vertex) {
+                    result.vertices[result_vertex(vi)] = part.its.vertices[vi];
+                    quadrics[result_vertex(vi)] = part.quadrics[vi];
+                }
+            Triangle *out = result.indices.data() + triangle_offsets[pi];
+            for (const Triangle &t : part.its.indices)
+                *out++ = Triangle(result_vertex(t[0]), result_vertex(t[1]), result_vertex(t[2]));
+        }
+    }); // END parallel for
+    its = std::move(result);
+
+    float last_collapsed_error = 0.f;
+    for (const Part &part : parts)
+        last_collapsed_error = std::max(last_collapsed_error, part.error);
+    parts.clear();
+
+    // final pass collapses the seams between parts, it continues with the quadrics of parts
+    StatusFn final_status_fn = [&](int percent) {
+        status_fn(status_partitions_size + percent * (100 - status_partitions_size) / 100);
+    };
+    float final_error = simplify(its, triangle_count, maximal_error, &quadrics, throw_on_cancel, final_status_fn);
+    last_collapsed_error = std::max(last_collapsed_error, final_error);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+std::vector<std::vector<uint32_t>> QuadricEdgeCollapse::create_partitions(const indexed_triangle_set &its, int depth)
+{
+    std::vector<Vec3f> centers(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t ti = range.begin(); ti < range.end(); ++ti) {
+            const Triangle &t = its.indices[ti];
+            centers[ti] = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+        }
+    }); // END parallel for
+
+    std::vector<uint32_t> tis(its.indices.size());
+    std::iota(tis.begin(), tis.end(), 0);
+    std::vector<std::vector<uint32_t>> partitions(size_t(1) << depth);
+    // split by median of triangle centers along the longest side of their bounding box
+    std::function<void(size_t, size_t, size_t, int)> split =
+        [&](size_t begin, size_t end, size_t partition_index, int level) {
+        if (level == 0) {
+            partitions[partition_index].assign(tis.begin() + begin, tis.begin() + end);
+            return;
+        }
+        Eigen::AlignedBox<float, 3> bb;
+        for (size_t i = begin; i < end; ++i) bb.extend(centers[tis[i]]);
+        int axis = 0;
+        bb.sizes().maxCoeff(&axis);
+        size_t mid = begin + (end - begin) / 2;
+        std::nth_element(tis.begin() + begin, tis.begin() + mid, tis.begin() + end,
+            [&centers, axis](uint32_t ti0, uint32_t ti1) { return centers[ti0][axis] < centers[ti1][axis]; });
+        tbb::parallel_invoke(
+            [&]() { split(begin, mid, 2 * partition_index, level - 1); },
+            [&]() { split(mid, end, 2 * partition_index + 1, level - 1); });
+    };
+    split(0, tis.size(), 0, depth);
+    return partitions;
+}
+
+float QuadricEdgeCollapse::simplify(indexed_triangle_set &     its,
+                                    uint32_t                   triangle_count,
+                                    float                      maximal_error,
+                                    const std::vector<SymMat> *vertex_quadrics,
+                                    ThrowOnCancel &            throw_on_cancel,
+                                    StatusFn &                 status_fn)
+{
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -196,10 +440,29 @@ void Slic3r::its_quadric_edge_collapse(
     VertexInfos   v_infos;
     EdgeInfos     e_infos;
     Errors        errors;
-    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn);
+    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn, vertex_quadrics);
     throw_on_cancel();
     status_fn(status_init_size);
 
+    float last_collapsed_error = collapse_edges(its, triangle_count, maximal_error, nullptr,
+        t_infos, v_infos, e_infos, errors, throw_on_cancel, status_fn);
+
+    // compact triangle
+    compact(v_infos, t_infos, e_infos, its);
+    return last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse_edges(indexed_triangle_set &its,
+                                          uint32_t              triangle_count,
+                                          float                 maximal_error,
+                                          const std::vector<bool> *locked,
+                                          TriangleInfos &       t_infos,
+                                          VertexInfos &         v_infos,
+                                          EdgeInfos &           e_infos,
+                                          const Errors &        errors,
+                                          ThrowOnCancel &       throw_on_cancel,
+                                          StatusFn &            status_fn)
+{
     //its_store_triangle_to_obj(its, "triangle.obj", 1182);
     //store_surround("triangle_surround1.obj", 1182, 1, its, v_infos, e_infos);
 
@@ -210,7 +473,7 @@ void Slic3r::its_quadric_edge_collapse(
     auto mpq = make_miniheap_mutable_priority_queue<Error, 32, false>(std::move(setter), std::move(less)); 
     //MutablePriorityQueue<Error, decltype(setter), decltype(less)> mpq(std::move(setter), std::move(less));
     mpq.reserve(its.indices.size());
-    for (Error &error :errors) mpq.push(error);
+    for (const Error &error : errors) mpq.push(error);
 
     CopyEdgeInfos ceis;
     ceis.reserve(max_triangle_count_for_one_vertex);
@@ -272,6 +535,7 @@ void Slic3r::its_quadric_edge_collapse(
             reorder_edges(e_infos, v_info1, ti0, ti1);
         }
         if (!ti1_opt.has_value() || // edge has only one triangle
+            (locked != nullptr && ((*locked)[vi0] || (*locked)[vi1])) ||
             degenerate(vi0, ti0, ti1, v_info1, e_infos, its.indices) ||
             degenerate(vi1, ti0, ti1, v_info0, e_infos, its.indices) ||
             create_no_volume(vi0, vi1, ti0, ti1, v_info0, v_info1, e_infos, its.indices) ||
@@ -357,9 +621,7 @@ void Slic3r::its_quadric_edge_collapse(
 #endif // EXPENSIVE_DEBUG_CHECKS
     }
 
-    // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
-    if (max_error != nullptr) *max_error = last_collapsed_error;
+    return last_collapsed_error;
 }
 
 Vec3d QuadricEdgeCollapse::create_normal(const Triangle &triangle,
@@ -454,13 +716,16 @@ SymMat QuadricEdgeCollapse::create_quadric(const Triangle &t,
 }
 
 std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
+QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn,
+                          const std::vector<SymMat> *vertex_quadrics)
 {
+    assert(vertex_quadrics == nullptr || vertex_quadrics->size() == its.vertices.size());
     int status_offset = 0;
     TriangleInfos t_infos(its.indices.size());
     VertexInfos   v_infos(its.vertices.size());
     {
-        std::vector<SymMat> triangle_quadrics(its.indices.size());
+        // given vertex quadrics replace the sum of triangle quadrics
+        std::vector<SymMat> triangle_quadrics(vertex_quadrics == nullptr ? its.indices.size() : 0);
         // calculate normals
         tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
         [&](const tbb::blocked_range<size_t> &range) {
@@ -469,7 +734,8 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
                 TriangleInfo &  t_info = t_infos[i];
                 Vec3d           normal = create_normal(t, its.vertices);
                 t_info.n = normal.cast<float>();
-                triangle_quadrics[i] = create_quadric(t, normal, its.vertices);
+                if (vertex_quadrics == nullptr)
+                    triangle_quadrics[i] = create_quadric(t, normal, its.vertices);
                 if (i % 1000000 == 0) {
                     throw_on_cancel();
                     status_fn(status_offset + (i * status_normal_size) / its.indices.size());
@@ -481,10 +747,10 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
         // sum quadrics
         for (size_t i = 0; i < its.indices.size(); i++) {
             const Triangle &t = its.indices[i];
-            const SymMat &  q = triangle_quadrics[i];
             for (size_t e = 0; e < 3; e++) {
                 VertexInfo &v_info = v_infos[t[e]];
-                v_info.q += q;
+                if (vertex_quadrics == nullptr)
+                    v_info.q += triangle_quadrics[i];
                 ++v_info.count; // triangle count
             }
             if (i % 1000000 == 0) {
@@ -492,6 +758,9 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
                 status_fn(status_offset + (i * status_sum_quadric) / its.indices.size());
             }
         }
+        if (vertex_quadrics != nullptr)
+            for (size_t i = 0; i < v_infos.size(); i++)
+                v_infos[i].q = (*vertex_quadrics)[i];
         status_offset += status_sum_quadric;
     } // remove triangle quadrics
 
@@ -12,6 +12,7 @@ struct indexed_triangle_set;
 #ifndef PRUSASLICER_QUADRIC_EDGE_COLLAPSE_HPP
 #define PRUSASLICER_QUADRIC_EDGE_COLLAPSE_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 
@@ -36,6 +37,30 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify mesh by Quadric metric in parallel.
+/// Mesh is split into spatial parts simplified independently,
+/// vertices shared by more parts are kept until the final pass over the whole mesh.
+/// Result differs from its_quadric_edge_collapse only near the seams of parts.
+/// </summary>
+/// <param name="its">IN/OUT triangle mesh to be simplified.</param>
+/// <param name="triangle_count">Wanted triangle count.</param>
+/// <param name="max_error">Maximal Quadric for reduce.
+/// When nullptr then max float is used
+/// Output: Biggest of last used ErrorValues to collapse edge</param>
+/// <param name="throw_on_cancel">Could stop process of calculation, called from worker threads.</param>
+/// <param name="statusfn">Give a feed back to user about progress. Values 1 - 100, called from worker threads</param>
+/// <param name="partition_triangle_count">Maximal triangle count of one part.
+/// When zero then it is derived from mesh size and count of threads.
+/// Mesh smaller than two parts is simplified by its_quadric_edge_collapse</param>
+void its_quadric_edge_collapse_partitioned(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count           = 0,
+    float *                   max_error                = nullptr,
+    std::function<void(void)> throw_on_cancel          = nullptr,
+    std::function<void(int)>  statusfn                 = nullptr,
+    size_t                    partition_triangle_count = 0);
+
 } // namespace Slic3r
 #endif // slic3r_quadric_edge_collapse_hpp_
 
@@ -42,6 +42,9 @@ void pad_blueprint(
     float         layerheight    = 0.05f, // The sampling height
     ThrowOnCancel thrfn          = [] {});
 
+/// Merge the already sliced layers into the silhouette.
+void pad_blueprint(std::vector<ExPolygons> &&slices, ExPolygons &output);
+
 struct PadConfig {
     double wall_thickness_mm = 1.;
     double wall_height_mm = 1.;
@@ -11,6 +11,7 @@
 #include <libslic3r/SLA/SupportTreeBuilder.hpp>
 #include <libslic3r/SLA/DefaultSupportTree.hpp>
 #include <libslic3r/SLA/BranchingTreeSLA.hpp>
+#include <libslic3r/SLA/SupportTreeSlicer.hpp>
 #include <libslic3r/MTUtils.hpp>
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <boost/log/trivial.hpp>
@@ -29,7 +30,8 @@
 namespace Slic3r { namespace sla {
 
 indexed_triangle_set create_support_tree(const SupportableMesh &sm,
-                                         const JobController   &ctl)
+                                         const JobController   &ctl,
+                                         SupportTreePrimitives *primitives)
 {
     auto builder = make_unique<SupportTreeBuilder>(ctl);
 
@@ -60,6 +62,9 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
                                 << duration<double>{stop - start}.count()
                                 << " seconds";
 
+        if (primitives)
+            *primitives = builder->primitives();
+
         builder->merge_and_cleanup();   // clean metadata, leave only the meshes.
     }
 
@@ -68,18 +73,28 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
     return out;
 }
 
-indexed_triangle_set create_pad(const SupportableMesh      &sm,
-                                const indexed_triangle_set &support_mesh,
-                                const JobController        &ctl)
-{
-    constexpr float PadSamplingLH = 0.1f;
+namespace {
 
-    ExPolygons model_contours; // This will store the base plate of the pad.
+constexpr float PadSamplingLH = 0.1f;
+
+// Z levels at which the supports are sampled for the pad blueprint
+std::vector<float> pad_sampling_grid(const SupportableMesh &sm)
+{
     double pad_h  = sm.pad_cfg.full_height();
     auto   gndlvl = float(ground_level(sm));
     float  zstart = gndlvl - bool(sm.pad_cfg.embed_object) * sm.pad_cfg.wall_thickness_mm;
     float  zend   = zstart + float(pad_h + PadSamplingLH + EPSILON);
-    auto  heights = grid(zstart, zend, PadSamplingLH);
+
+    return grid(zstart, zend, PadSamplingLH);
+}
+
+indexed_triangle_set create_pad_from_blueprint(const SupportableMesh    &sm,
+                                               const ExPolygons         &sup_contours,
+                                               const std::vector<float> &heights,
+                                               const JobController      &ctl)
+{
+    ExPolygons model_contours; // This will store the base plate of the pad.
+    auto gndlvl = float(ground_level(sm));
 
     if (!sm.cfg.enabled || sm.pad_cfg.embed_object) {
         // No support (thus no elevation) or zero elevation mode
@@ -90,9 +105,6 @@ indexed_triangle_set create_pad(const SupportableMesh      &sm,
                            heights, ctl.cancelfn);
     }
 
-    ExPolygons sup_contours;
-    pad_blueprint(support_mesh, sup_contours, heights, ctl.cancelfn);
-
     indexed_triangle_set out;
     create_pad(sup_contours, model_contours, out, sm.pad_cfg);
 
@@ -104,6 +116,34 @@ indexed_triangle_set create_pad(const SupportableMesh      &sm,
     return out;
 }
 
+} // namespace
+
+indexed_triangle_set create_pad(const SupportableMesh      &sm,
+                                const indexed_triangle_set &support_mesh,
+                                const JobController        &ctl)
+{
+    auto heights = pad_sampling_grid(sm);
+
+    ExPolygons sup_contours;
+    pad_blueprint(support_mesh, sup_contours, heights, ctl.cancelfn);
+
+    return create_pad_from_blueprint(sm, sup_contours, heights, ctl);
+}
+
+indexed_triangle_set create_pad(const SupportableMesh       &sm,
+                                const SupportTreePrimitives &support_tree,
+                                const JobController         &ctl)
+{
+    auto heights = pad_sampling_grid(sm);
+
+    ExPolygons sup_contours;
+    if (!support_tree.empty())
+        pad_blueprint(slice_support_tree(support_tree, heights, 0.f, 45, ctl.cancelfn),
+                      sup_contours);
+
+    return create_pad_from_blueprint(sm, sup_contours, heights, ctl);
+}
+
 std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
                               const indexed_triangle_set &pad_mesh,
                               const std::vector<float>   &grid,
@@ -152,4 +192,24 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
     return mrg;
 }
 
+std::vector<ExPolygons> slice(const SupportTreePrimitives &support_tree,
+                              const indexed_triangle_set  &pad_mesh,
+                              const std::vector<float>    &grid,
+                              float                        cr,
+                              const JobController         &ctl)
+{
+    if (support_tree.empty())
+        return slice(indexed_triangle_set{}, pad_mesh, grid, cr, ctl);
+
+    std::vector<ExPolygons> slices = slice_support_tree(support_tree, grid, cr, 45, ctl.cancelfn);
+
+    if (!pad_mesh.empty()) {
+        std::vector<ExPolygons> pad_slices = slice(indexed_triangle_set{}, pad_mesh, grid, cr, ctl);
+        for (size_t i = 0; i < std::min(slices.size(), pad_slices.size()); ++i)
+            std::move(pad_slices[i].begin(), pad_slices[i].end(), std::back_inserter(slices[i]));
+    }
+
+    return slices;
+}
+
 }} // namespace Slic3r::sla
@@ -24,6 +24,7 @@ namespace Slic3r {
 
 namespace sla {
 struct JobController;
+struct SupportTreePrimitives;
 
 struct SupportTreeConfig
 {
@@ -148,19 +149,35 @@ inline double ground_level(const SupportableMesh &sm)
     return lvl;
 }
 
+// If primitives is not null, it receives the logical parts of the tree,
+// which can be sliced without the returned mesh.
 indexed_triangle_set create_support_tree(const SupportableMesh &mesh,
-                                         const JobController   &ctl);
+                                         const JobController   &ctl,
+                                         SupportTreePrimitives *primitives = nullptr);
 
 indexed_triangle_set create_pad(const SupportableMesh      &model_mesh,
                                 const indexed_triangle_set &support_mesh,
                                 const JobController        &ctl);
 
+// Same as above, the base of the supports is sliced from the primitives.
+indexed_triangle_set create_pad(const SupportableMesh       &model_mesh,
+                                const SupportTreePrimitives &support_tree,
+                                const JobController         &ctl);
+
 std::vector<ExPolygons> slice(const indexed_triangle_set &support_mesh,
                               const indexed_triangle_set &pad_mesh,
                               const std::vector<float>   &grid,
                               float                       closing_radius,
                               const JobController        &ctl);
 
+// Same as above, but the support tree is sliced analytically from its
+// primitives (see SupportTreeSlicer.hpp).
+std::vector<ExPolygons> slice(const SupportTreePrimitives &support_tree,
+                              const indexed_triangle_set  &pad_mesh,
+                              const std::vector<float>    &grid,
+                              float                        closing_radius,
+                              const JobController         &ctl);
+
 } // namespace sla
 } // namespace Slic3r
 
@@ -31,8 +31,12 @@ SupportTreeBuilder::SupportTreeBuilder(SupportTreeBuilder &&o)
     : m_heads(std::move(o.m_heads))
     , m_head_indices{std::move(o.m_head_indices)}
     , m_pillars{std::move(o.m_pillars)}
+    , m_junctions{std::move(o.m_junctions)}
     , m_bridges{std::move(o.m_bridges)}
     , m_crossbridges{std::move(o.m_crossbridges)}
+    , m_diffbridges{std::move(o.m_diffbridges)}
+    , m_pedestals{std::move(o.m_pedestals)}
+    , m_anchors{std::move(o.m_anchors)}
     , m_meshcache{std::move(o.m_meshcache)}
     , m_meshcache_valid{o.m_meshcache_valid}
     , m_model_height{o.m_model_height}
@@ -42,8 +46,12 @@ SupportTreeBuilder::SupportTreeBuilder(const SupportTreeBuilder &o)
     : m_heads(o.m_heads)
     , m_head_indices{o.m_head_indices}
     , m_pillars{o.m_pillars}
+    , m_junctions{o.m_junctions}
     , m_bridges{o.m_bridges}
     , m_crossbridges{o.m_crossbridges}
+    , m_diffbridges{o.m_diffbridges}
+    , m_pedestals{o.m_pedestals}
+    , m_anchors{o.m_anchors}
     , m_meshcache{o.m_meshcache}
     , m_meshcache_valid{o.m_meshcache_valid}
     , m_model_height{o.m_model_height}
@@ -56,6 +64,10 @@ SupportTreeBuilder &SupportTreeBuilder::operator=(SupportTreeBuilder &&o)
     m_pillars = std::move(o.m_pillars);
     m_bridges = std::move(o.m_bridges);
     m_crossbridges = std::move(o.m_crossbridges);
+    m_junctions = std::move(o.m_junctions);
+    m_diffbridges = std::move(o.m_diffbridges);
+    m_pedestals = std::move(o.m_pedestals);
+    m_anchors = std::move(o.m_anchors);
     m_meshcache = std::move(o.m_meshcache);
     m_meshcache_valid = o.m_meshcache_valid;
     m_model_height = o.m_model_height;
@@ -69,6 +81,10 @@ SupportTreeBuilder &SupportTreeBuilder::operator=(const SupportTreeBuilder &o)
     m_pillars = o.m_pillars;
     m_bridges = o.m_bridges;
     m_crossbridges = o.m_crossbridges;
+    m_junctions = o.m_junctions;
+    m_diffbridges = o.m_diffbridges;
+    m_pedestals = o.m_pedestals;
+    m_anchors = o.m_anchors;
     m_meshcache = o.m_meshcache;
     m_meshcache_valid = o.m_meshcache_valid;
     m_model_height = o.m_model_height;
@@ -87,6 +103,29 @@ void SupportTreeBuilder::add_pillar_base(long pid, double baseheight, double rad
     m_meshcache_valid = false;
 }
 
+SupportTreePrimitives SupportTreeBuilder::primitives() const
+{
+    std::lock_guard<Mutex> lk(m_mutex);
+
+    SupportTreePrimitives ret;
+
+    std::copy_if(m_heads.begin(), m_heads.end(), std::back_inserter(ret.heads),
+                 [](const Head &h) { return h.is_valid(); });
+
+    ret.pillars   = m_pillars;
+    ret.pedestals = m_pedestals;
+    ret.junctions = m_junctions;
+
+    ret.bridges = reserve_vector<Bridge>(m_bridges.size() + m_crossbridges.size());
+    ret.bridges.insert(ret.bridges.end(), m_bridges.begin(), m_bridges.end());
+    ret.bridges.insert(ret.bridges.end(), m_crossbridges.begin(), m_crossbridges.end());
+
+    ret.diffbridges = m_diffbridges;
+    ret.anchors     = m_anchors;
+
+    return ret;
+}
+
 const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
 {
     if (m_meshcache_valid) return m_meshcache;
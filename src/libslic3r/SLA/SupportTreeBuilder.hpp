@@ -220,6 +220,26 @@ struct DiffBridge: public Bridge {
     {}
 };
 
+// Logical parts of a finished support tree. They are kept after the support
+// mesh is generated, so that the supports can be sliced directly from them
+// (see SupportTreeSlicer.hpp) instead of slicing the much larger mesh.
+struct SupportTreePrimitives {
+    std::vector<Head>       heads;       // only the valid ones
+    std::vector<Pillar>     pillars;
+    std::vector<Pedestal>   pedestals;
+    std::vector<Junction>   junctions;
+    std::vector<Bridge>     bridges;     // including the crossbridges
+    std::vector<DiffBridge> diffbridges;
+    std::vector<Anchor>     anchors;
+
+    bool empty() const
+    {
+        return heads.empty() && pillars.empty() && pedestals.empty() &&
+               junctions.empty() && bridges.empty() && diffbridges.empty() &&
+               anchors.empty();
+    }
+};
+
 // This class will hold the support tree parts (not meshes, but logical parts)
 // with some additional bookkeeping as well. Various parts of the support
 // geometry are stored separately and are merged when the caller queries the
@@ -432,6 +452,10 @@ public:
         return m_pillars[size_t(id)];
     }
 
+    // Copy of the logical parts, intended to be called after the generation
+    // is complete but before merge_and_cleanup().
+    SupportTreePrimitives primitives() const;
+
     // WITHOUT THE PAD!!!
     const indexed_triangle_set &merged_mesh(size_t steps = 45) const;
     
@@ -0,0 +1,293 @@
+#include "SupportTreeSlicer.hpp"
+
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include <limits>
+
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Geometry/ConvexHull.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
+#include "libslic3r/libslic3r.h"
+
+namespace Slic3r { namespace sla {
+
+namespace {
+
+// Convex solid of revolution given by its profile: circles perpendicular to
+// the axis, ordered by their distance from the origin along the axis. A circle
+// with zero radius is the pole of a spherical cap. The circles are
+// approximated by regular polygons, the same way as in SupportTreeMesher.
+struct RevolvedSolid {
+    Vec3d origin;
+    Vec3d axis; // unit vector
+    Vec3d u, v; // unit vectors perpendicular to the axis and to each other
+    std::vector<Vec2d> profile; // (distance along the axis, radius)
+    double zmin = 0., zmax = 0.;
+
+    RevolvedSolid(const Vec3d &o, const Vec3d &ax, std::vector<Vec2d> &&prof)
+        : origin{o}, axis{ax.normalized()}, profile{std::move(prof)}
+    {
+        u = axis.unitOrthogonal();
+        v = axis.cross(u);
+
+        // Extent of a circle in Z depends on the tilt of the axis only.
+        const double rz = std::sqrt(std::max(0., 1. - axis.z() * axis.z()));
+        zmin = std::numeric_limits<double>::max();
+        zmax = std::numeric_limits<double>::lowest();
+        for (const Vec2d &c : profile) {
+            double z = origin.z() + c.x() * axis.z();
+            zmin = std::min(zmin, z - c.y() * rz);
+            zmax = std::max(zmax, z + c.y() * rz);
+        }
+    }
+
+    bool is_vertical() const { return std::abs(axis.z()) > 1. - EPSILON; }
+};
+
+struct Sphere {
+    Vec3d  center;
+    double r;
+};
+
+// Unit circle approximated by a regular polygon.
+std::vector<Vec2d> unit_circle(size_t steps)
+{
+    auto ret = reserve_vector<Vec2d>(steps);
+    for (size_t i = 0; i < steps; ++i) {
+        double phi = 2. * PI * double(i) / double(steps);
+        ret.emplace_back(std::cos(phi), std::sin(phi));
+    }
+
+    return ret;
+}
+
+Polygon make_circle(const Vec2d &center, double r, const std::vector<Vec2d> &circle)
+{
+    Polygon ret;
+    ret.points.reserve(circle.size());
+    for (const Vec2d &c : circle)
+        ret.points.emplace_back(scaled(center.x() + r * c.x()), scaled(center.y() + r * c.y()));
+
+    return ret;
+}
+
+// Profile of two spheres connected by a tangential cone (see pinhead()),
+// starting at the pole of the back sphere, which is centered at the origin.
+std::vector<Vec2d> pinhead_profile(double r_pin, double r_back, double length, size_t steps)
+{
+    std::vector<Vec2d> ret;
+
+    const double h   = r_back + r_pin + length;
+    const double n_s = (r_back - r_pin) / h;
+    if (std::abs(n_s) > 1.)
+        return ret;
+
+    // Polar angle of the circles touching the cone, measured from the axis.
+    const double theta_tangent = std::acos(n_s);
+    const double step          = 2. * PI / double(steps);
+
+    ret.emplace_back(-r_back, 0.);
+
+    for (double theta = PI - step; theta > theta_tangent; theta -= step)
+        ret.emplace_back(r_back * std::cos(theta), r_back * std::sin(theta));
+
+    ret.emplace_back(r_back * std::cos(theta_tangent), r_back * std::sin(theta_tangent));
+    ret.emplace_back(h + r_pin * std::cos(theta_tangent), r_pin * std::sin(theta_tangent));
+
+    for (double theta = theta_tangent - step; theta > 0.; theta -= step)
+        ret.emplace_back(h + r_pin * std::cos(theta), r_pin * std::sin(theta));
+
+    ret.emplace_back(h + r_pin, 0.);
+
+    return ret;
+}
+
+std::vector<RevolvedSolid> revolved_solids(const SupportTreePrimitives &prims, size_t steps)
+{
+    std::vector<RevolvedSolid> ret;
+    ret.reserve(prims.heads.size() + prims.anchors.size() + prims.pillars.size() +
+                prims.pedestals.size() + prims.bridges.size() + prims.diffbridges.size());
+
+    auto add_head = [&ret, steps](const Head &h) {
+        std::vector<Vec2d> prof = pinhead_profile(h.r_pin_mm, h.r_back_mm, h.width_mm, steps);
+        if (!prof.empty())
+            ret.emplace_back(h.junction_point(), -h.dir, std::move(prof));
+    };
+
+    // Same conditions for an empty mesh as in halfcone()
+    auto add_cone = [&ret](const Vec3d &pos, const Vec3d &dir, double h, double r_bottom, double r_top) {
+        if (h > 0. && (r_bottom > 0. || r_top > 0.))
+            ret.emplace_back(pos, dir, std::vector<Vec2d>{{0., r_bottom}, {h, r_top}});
+    };
+
+    for (const Head &h : prims.heads)
+        add_head(h);
+
+    for (const Anchor &a : prims.anchors)
+        add_head(a);
+
+    for (const Pillar &p : prims.pillars)
+        if (p.height > EPSILON)
+            add_cone(p.endpt, Vec3d::UnitZ(), p.height, p.r_end, p.r_start);
+
+    for (const Pedestal &p : prims.pedestals)
+        add_cone(p.pos, Vec3d::UnitZ(), p.height, p.r_bottom, p.r_top);
+
+    for (const Bridge &br : prims.bridges)
+        if (double d = br.get_length(); d > 0. && br.r > 0.)
+            ret.emplace_back(br.startp, br.get_dir(), std::vector<Vec2d>{{0., br.r}, {d, br.r}});
+
+    for (const DiffBridge &br : prims.diffbridges)
+        if (double d = br.get_length(); d > 0.)
+            add_cone(br.startp, br.get_dir(), d, br.r, br.end_r);
+
+    return ret;
+}
+
+// Cross-section of a solid with a vertical axis is a circle, its radius
+// is interpolated from the profile.
+Polygon slice_vertical(const RevolvedSolid &solid, double z, const std::vector<Vec2d> &circle)
+{
+    const double s  = (z - solid.origin.z()) / solid.axis.z();
+    const auto  &pr = solid.profile;
+
+    auto it = std::lower_bound(pr.begin(), pr.end(), s,
+                               [](const Vec2d &c, double s) { return c.x() < s; });
+
+    if (it == pr.end() || (it == pr.begin() && it->x() > s))
+        return {};
+
+    double r = it->y();
+    if (it != pr.begin() && it->x() > s) {
+        const Vec2d &prev = *std::prev(it);
+        double t = (s - prev.x()) / (it->x() - prev.x());
+        r = prev.y() + t * (it->y() - prev.y());
+    }
+
+    if (r <= 0.)
+        return {};
+
+    Vec3d c = solid.origin + s * solid.axis;
+    return make_circle(Vec2d{c.x(), c.y()}, r, circle);
+}
+
+// Cross-section of a general solid is the convex hull of the intersections
+// of the polygon edges of the circles and of the edges connecting
+// the neighboring circles with the slicing plane.
+Polygon slice_general(const RevolvedSolid &solid, double z, const std::vector<Vec2d> &circle, Points &pts)
+{
+    pts.clear();
+
+    auto intersect = [z, &pts](const Vec3d &a, const Vec3d &b) {
+        if ((a.z() < z) != (b.z() < z)) {
+            double t = (z - a.z()) / (b.z() - a.z());
+            Vec3d  p = a + t * (b - a);
+            pts.emplace_back(scaled(p.x()), scaled(p.y()));
+        }
+    };
+
+    auto ring_point = [&solid, &circle](const Vec2d &c, size_t k) -> Vec3d {
+        // A single point for the poles.
+        if (c.y() <= 0.)
+            return solid.origin + c.x() * solid.axis;
+
+        const Vec2d &cs = circle[k];
+        return solid.origin + c.x() * solid.axis + c.y() * (cs.x() * solid.u + cs.y() * solid.v);
+    };
+
+    const size_t steps = circle.size();
+    for (size_t i = 0; i < solid.profile.size(); ++i) {
+        const Vec2d &c = solid.profile[i];
+        for (size_t k = 0; k < steps; ++k) {
+            Vec3d p = ring_point(c, k);
+            if (c.y() > 0.)
+                intersect(p, ring_point(c, (k + 1) % steps));
+            if (i + 1 < solid.profile.size())
+                intersect(p, ring_point(solid.profile[i + 1], k));
+        }
+    }
+
+    if (pts.size() < 3)
+        return {};
+
+    return Geometry::convex_hull(pts);
+}
+
+} // namespace
+
+std::vector<ExPolygons> slice_support_tree(const SupportTreePrimitives &prims,
+                                           const std::vector<float>    &grid,
+                                           float                        cr,
+                                           size_t                       steps,
+                                           ThrowOnCancel                thr)
+{
+    std::vector<ExPolygons> ret(grid.size());
+    if (prims.empty() || grid.empty())
+        return ret;
+
+    assert(std::is_sorted(grid.begin(), grid.end()));
+
+    const std::vector<Vec2d>         circle = unit_circle(steps);
+    const std::vector<RevolvedSolid> solids = revolved_solids(prims, steps);
+
+    auto spheres = reserve_vector<Sphere>(prims.junctions.size());
+    for (const Junction &j : prims.junctions)
+        if (j.r > 1e-6)
+            spheres.push_back({j.pos, j.r});
+
+    // Indices of the primitives crossing each layer: spheres first, then
+    // the revolved solids.
+    std::vector<std::vector<size_t>> layer_primitives(grid.size());
+    auto add_to_layers = [&grid, &layer_primitives](size_t idx, double zmin, double zmax) {
+        auto from = std::lower_bound(grid.begin(), grid.end(), zmin);
+        auto to   = std::upper_bound(from, grid.end(), zmax);
+        for (auto it = from; it != to; ++it)
+            layer_primitives[size_t(it - grid.begin())].emplace_back(idx);
+    };
+
+    for (size_t i = 0; i < spheres.size(); ++i)
+        add_to_layers(i, spheres[i].center.z() - spheres[i].r, spheres[i].center.z() + spheres[i].r);
+
+    for (size_t i = 0; i < solids.size(); ++i)
+        add_to_layers(spheres.size() + i, solids[i].zmin, solids[i].zmax);
+
+    thr();
+
+    execution::for_each(ex_tbb, size_t(0), grid.size(), [&](size_t layer_idx) {
+        const std::vector<size_t> &idxs = layer_primitives[layer_idx];
+        if (idxs.empty())
+            return;
+
+        thr();
+
+        const double z = grid[layer_idx];
+        Polygons     polys;
+        polys.reserve(idxs.size());
+        Points       pts;
+
+        for (size_t idx : idxs) {
+            Polygon poly;
+            if (idx < spheres.size()) {
+                const Sphere &sph = spheres[idx];
+                double dz = z - sph.center.z();
+                if (double r2 = sph.r * sph.r - dz * dz; r2 > 0.)
+                    poly = make_circle(Vec2d{sph.center.x(), sph.center.y()}, std::sqrt(r2), circle);
+            } else {
+                const RevolvedSolid &solid = solids[idx - spheres.size()];
+                poly = solid.is_vertical() ? slice_vertical(solid, z, circle) :
+                                             slice_general(solid, z, circle, pts);
+            }
+
+            if (poly.size() >= 3)
+                polys.emplace_back(std::move(poly));
+        }
+
+        ret[layer_idx] = cr > 0.f ? closing_ex(polys, scaled<float>(cr)) : union_ex(polys);
+    }, execution::max_concurrency(ex_tbb));
+
+    return ret;
+}
+
+}} // namespace Slic3r::sla
@@ -0,0 +1,27 @@
+#ifndef SLA_SUPPORTTREESLICER_HPP
+#define SLA_SUPPORTTREESLICER_HPP
+
+#include <stddef.h>
+#include <vector>
+
+#include "libslic3r/ExPolygon.hpp"
+#include "libslic3r/SLA/Pad.hpp"
+#include "libslic3r/SLA/SupportTreeBuilder.hpp"
+
+namespace Slic3r { namespace sla {
+
+// Slice the support tree at the given Z levels directly from its primitives,
+// without meshing them. Every primitive is a convex solid, thus its
+// cross-section is the convex hull of the intersections of its mesh edges
+// (see SupportTreeMesher.hpp, generated with the same number of steps) with
+// the slicing plane. The cross-sections are unioned per layer in parallel.
+std::vector<ExPolygons> slice_support_tree(
+    const SupportTreePrimitives &primitives,
+    const std::vector<float>    &grid,
+    float                        closing_radius,
+    size_t                       steps = 45,
+    ThrowOnCancel                thr   = [] {});
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_SUPPORTTREESLICER_HPP
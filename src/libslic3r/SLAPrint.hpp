@@ -26,6 +26,7 @@
 
 #include "PrintBase.hpp"
 #include "SLA/SupportTree.hpp"
+#include "SLA/SupportTreeBuilder.hpp"
 #include "SLA/SupportPointGenerator.hpp" // SupportPointGeneratorData
 #include "Point.hpp"
 #include "Format/SLAArchiveWriter.hpp"
@@ -376,6 +377,7 @@ private:
         sla::SupportableMesh    input; // the input
         std::vector<ExPolygons> support_slices;   // sliced supports
         TriangleMesh tree_mesh, pad_mesh, full_mesh; // cached artifacts
+        sla::SupportTreePrimitives tree_primitives; // sliced instead of tree_mesh
         
         inline SupportData(const TriangleMesh &t)
             : input{t.its, {}, {}}
@@ -387,12 +389,13 @@ private:
         
         void create_support_tree(const sla::JobController &ctl)
         {
-            tree_mesh = TriangleMesh{sla::create_support_tree(input, ctl)};
+            tree_primitives = {};
+            tree_mesh = TriangleMesh{sla::create_support_tree(input, ctl, &tree_primitives)};
         }
 
         void create_pad(const sla::JobController &ctl)
         {
-            pad_mesh = TriangleMesh{sla::create_pad(input, tree_mesh.its, ctl)};
+            pad_mesh = TriangleMesh{sla::create_pad(input, tree_primitives, ctl)};
         }
     };
 
@@ -249,7 +249,7 @@ indexed_triangle_set SLAPrint::Steps::generate_preview_vdb(
     auto grid = csg::voxelize_csgmesh(r, voxparams);
     auto m = grid ? grid_to_mesh(*grid, 0., 0.01) : indexed_triangle_set{};
     float loss_less_max_error = float(1e-6);
-    its_quadric_edge_collapse(m, 0U, &loss_less_max_error);
+    its_quadric_edge_collapse_partitioned(m, 0U, &loss_less_max_error);
 
     return m;
 }
@@ -457,7 +457,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
         if (!m.empty()) {
             // simplify mesh lossless
             float loss_less_max_error = 2*std::numeric_limits<float>::epsilon();
-            its_quadric_edge_collapse(m, 0U, &loss_less_max_error);
+            its_quadric_edge_collapse_partitioned(m, 0U, &loss_less_max_error);
 
             its_compactify_vertices(m);
             its_merge_vertices(m);
@@ -956,7 +956,7 @@ void SLAPrint::Steps::slice_supports(SLAPrintObject &po) {
         ctl.cancelfn = [this]() { throw_if_canceled(); };
 
         sd->support_slices =
-            sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, heights,
+            sla::slice(sd->tree_primitives, sd->pad_mesh.its, heights,
                        float(po.config().slice_closing_radius.value), ctl);
     }
 
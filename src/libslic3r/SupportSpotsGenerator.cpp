@@ -939,7 +939,7 @@ std::vector<EnitityToCheck> gather_entities_to_check(const Layer* layer) {
 
 LocalSupports compute_local_supports(
     const std::vector<EnitityToCheck>& entities_to_check,
-    const std::optional<Linesf>& previous_layer_boundary,
+    const AABBTreeLines::LinesDistancer<Linef>& prev_layer_boundary_distancer,
     const LD& prev_layer_ext_perim_lines,
     size_t slices_count,
     const Params& params
@@ -947,9 +947,6 @@ LocalSupports compute_local_supports(
     std::vector<tbb::concurrent_vector<ExtrusionLine>> unstable_lines_per_slice(slices_count);
     std::vector<tbb::concurrent_vector<ExtrusionLine>> ext_perim_lines_per_slice(slices_count);
 
-    AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary_distancer =
-        (previous_layer_boundary ? AABBTreeLines::LinesDistancer<Linef>{*previous_layer_boundary} : AABBTreeLines::LinesDistancer<Linef>{});
-
     if constexpr (debug_files) {
         for (const auto &e_to_check : entities_to_check) {
             for (const auto &line : check_extrusion_entity_stability(e_to_check.e, e_to_check.region, prev_layer_ext_perim_lines,
@@ -998,8 +995,51 @@ std::optional<PartialObject> to_partial_object(const ObjectPart& part) {
     return {};
 }
 
+// Data of a single layer, which does not depend on the results of the layers below.
+// It is precomputed for all layers in parallel, only the propagation of the object parts,
+// their weakest connections and the curling of the extrusions is done layer by layer.
+struct LayerLocalData
+{
+    std::vector<EnitityToCheck>          entities_to_check;
+    // Distancer over the slices of the layer below, empty for the first layer.
+    AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary_distancer;
+    // Object part made of the extrusions of each slice of this layer, indexed by slice_idx.
+    std::vector<ObjectPart>              slice_parts;
+};
+
+std::vector<LayerLocalData> precompute_layers_local_data(const PrintObject *po, const Params &params)
+{
+    std::vector<LayerLocalData> result(po->layer_count());
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, po->layer_count()), [po, &params, &result](tbb::blocked_range<size_t> r) {
+        for (size_t lidx = r.begin(); lidx < r.end(); ++lidx) {
+            const Layer    *layer = po->get_layer(lidx);
+            LayerLocalData &data  = result[lidx];
+
+            data.entities_to_check = gather_entities_to_check(layer);
+            if (layer->lower_layer != nullptr)
+                data.prev_layer_boundary_distancer = AABBTreeLines::LinesDistancer<Linef>{to_unscaled_linesf(layer->lower_layer->lslices)};
+
+            const bool connected_to_bed = int(layer->id()) == params.raft_layers_count;
+            const bool layer_has_brim   = has_brim(layer, params);
+            data.slice_parts.reserve(layer->lslices_ex.size());
+            for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
+                const std::optional<Polygons> brim{
+                    layer_has_brim ?
+                    std::optional{get_brim(layer->lslices[slice_idx], params.brim_type, params.brim_width)} :
+                    std::nullopt
+                };
+                data.slice_parts.emplace_back(gather_extrusions(layer->lslices_ex[slice_idx], layer), connected_to_bed, layer->print_z,
+                                              layer->height, brim);
+            }
+        }
+    });
+
+    return result;
+}
+
 SliceMappings update_active_object_parts(const Layer                        *layer,
-                                         const Params                       &params,
+                                         const std::vector<ObjectPart>      &slice_parts,
                                          const std::vector<SliceConnection> &precomputed_slice_connections,
                                          const SliceMappings                &previous_slice_mappings,
                                          ActiveObjectParts                  &active_object_parts,
@@ -1009,21 +1049,7 @@ SliceMappings update_active_object_parts(const Layer                        *lay
 
     for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
         const LayerSlice &slice             = layer->lslices_ex.at(slice_idx);
-        const std::vector<const ExtrusionEntityCollection*> extrusion_collections{gather_extrusions(slice, layer)};
-        const bool connected_to_bed = int(layer->id()) == params.raft_layers_count;
-
-        const std::optional<Polygons> brim{
-             has_brim(layer, params) ?
-             std::optional{get_brim(layer->lslices[slice_idx], params.brim_type, params.brim_width)} :
-             std::nullopt
-        };
-        ObjectPart new_part{
-            extrusion_collections,
-            connected_to_bed,
-            layer->print_z,
-            layer->height,
-            brim
-        };
+        const ObjectPart &new_part          = slice_parts[slice_idx];
 
         const SliceConnection &connection_to_below = precomputed_slice_connections[slice_idx];
 
@@ -1125,6 +1151,7 @@ void reckon_global_supports(const tbb::concurrent_vector<ExtrusionLine> &externa
 
 std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject                 *po,
                                                           const PrecomputedSliceConnections &precomputed_slices_connections,
+                                                          const std::vector<LayerLocalData> &layers_local_data,
                                                           const PrintTryCancel              &cancel_func,
                                                           const Params                      &params)
 {
@@ -1142,14 +1169,13 @@ std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject
         const Layer *layer                 = po->get_layer(layer_idx);
         float        bottom_z              = layer->bottom_z();
 
-        slice_mappings = update_active_object_parts(layer, params, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
+        const LayerLocalData &local_data = layers_local_data[layer_idx];
 
-        std::optional<Linesf> prev_layer_boundary = layer->lower_layer != nullptr ?
-                                                        std::optional{to_unscaled_linesf(layer->lower_layer->lslices)} :
-                                                        std::nullopt;
+        slice_mappings = update_active_object_parts(layer, local_data.slice_parts, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
 
+        // Curling of the current layer depends on the curling of the previous layer, thus the layers are processed one by one here.
         LocalSupports local_supports{
-            compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
+            compute_local_supports(local_data.entities_to_check, local_data.prev_layer_boundary_distancer, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
 
         std::vector<ExtrusionLine> current_layer_ext_perims_lines{};
         current_layer_ext_perims_lines.reserve(prev_layer_ext_perim_lines.get_lines().size());
@@ -1231,7 +1257,10 @@ void debug_export(const SupportPoints& support_points,const PartialObjects& obje
 std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const PrintTryCancel& cancel_func, const Params &params)
 {
     auto precomputed_slices_connections = precompute_slices_connections(po);
-    auto results = check_stability(po, precomputed_slices_connections, cancel_func, params);
+    cancel_func();
+    auto layers_local_data = precompute_layers_local_data(po, params);
+    cancel_func();
+    auto results = check_stability(po, precomputed_slices_connections, layers_local_data, cancel_func, params);
 #ifdef DEBUG_FILES
     auto [supp_points, objects] = results;
     debug_export(supp_points, objects, "issues");
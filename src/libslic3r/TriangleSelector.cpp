@@ -6,6 +6,9 @@
 
 #include <boost/container/small_vector.hpp>
 #include <boost/container/vector.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <cmath>
 #include <queue>
 #include <cstring>
@@ -481,13 +484,16 @@ std::pair<std::vector<Vec3i>, std::vector<Vec3i>> TriangleSelector::precompute_a
 {
     std::vector<Vec3i> neighbors(m_triangles.size(), Vec3i(-1, -1, -1));
     std::vector<Vec3i> neighbors_propagated(m_triangles.size(), Vec3i(-1, -1, -1));
-    for (int facet_idx = 0; facet_idx < m_orig_size_indices; ++facet_idx) {
-        neighbors[facet_idx]            = m_neighbors[facet_idx];
-        neighbors_propagated[facet_idx] = neighbors[facet_idx];
-        assert(this->verify_triangle_neighbors(m_triangles[facet_idx], neighbors[facet_idx]));
-        if (m_triangles[facet_idx].is_split())
-            this->precompute_all_neighbors_recursive(facet_idx, neighbors[facet_idx], neighbors_propagated[facet_idx], neighbors, neighbors_propagated);
-    }
+    // Each source triangle writes to its own subtree only, thus the source triangles may be processed in parallel.
+    tbb::parallel_for(tbb::blocked_range<int>(0, m_orig_size_indices), [this, &neighbors, &neighbors_propagated](const tbb::blocked_range<int> &range) {
+        for (int facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
+            neighbors[facet_idx]            = m_neighbors[facet_idx];
+            neighbors_propagated[facet_idx] = neighbors[facet_idx];
+            assert(this->verify_triangle_neighbors(m_triangles[facet_idx], neighbors[facet_idx]));
+            if (m_triangles[facet_idx].is_split())
+                this->precompute_all_neighbors_recursive(facet_idx, neighbors[facet_idx], neighbors_propagated[facet_idx], neighbors, neighbors_propagated);
+        }
+    });
     return std::make_pair(std::move(neighbors), std::move(neighbors_propagated));
 }
 
@@ -552,24 +558,59 @@ void TriangleSelector::append_touching_edges(int itriangle, int vertexi, int ver
         process_subtriangle(touching.second, Partition::Second);
 }
 
-// Returns all triangles that are touching the given facet.
-std::vector<int> TriangleSelector::get_all_touching_triangles(int facet_idx, const Vec3i &neighbors, const Vec3i &neighbors_propagated) const {
+// Appends all triangles that are touching the given facet.
+void TriangleSelector::append_all_touching_triangles(int facet_idx, const Vec3i &neighbors, const Vec3i &neighbors_propagated, std::vector<int> &touching_triangles_out) const {
     assert(facet_idx != -1 && facet_idx < int(m_triangles.size()));
     assert(this->verify_triangle_neighbors(m_triangles[facet_idx], neighbors));
 
     const Vec3i vertices = { m_triangles[facet_idx].verts_idxs[0], m_triangles[facet_idx].verts_idxs[1], m_triangles[facet_idx].verts_idxs[2] };
 
-    std::vector<int> touching_triangles;
-    append_touching_subtriangles(neighbors(0), vertices(1), vertices(0), touching_triangles);
-    append_touching_subtriangles(neighbors(1), vertices(2), vertices(1), touching_triangles);
-    append_touching_subtriangles(neighbors(2), vertices(0), vertices(2), touching_triangles);
+    append_touching_subtriangles(neighbors(0), vertices(1), vertices(0), touching_triangles_out);
+    append_touching_subtriangles(neighbors(1), vertices(2), vertices(1), touching_triangles_out);
+    append_touching_subtriangles(neighbors(2), vertices(0), vertices(2), touching_triangles_out);
 
     for (int neighbor_idx: neighbors_propagated) {
         if (neighbor_idx != -1 && !m_triangles[neighbor_idx].is_split())
-            touching_triangles.emplace_back(neighbor_idx);
+            touching_triangles_out.emplace_back(neighbor_idx);
     }
+}
 
-    return touching_triangles;
+TriangleSelector::TouchingTriangles TriangleSelector::collect_touching_triangles() const
+{
+    auto [neighbors, neighbors_propagated] = this->precompute_all_neighbors();
+
+    // Collect the touching triangles of blocks of leaf triangles in parallel, then concatenate the blocks.
+    const int                     block_size = 4096;
+    const int                     num_blocks = (int(m_triangles.size()) + block_size - 1) / block_size;
+    std::vector<std::vector<int>> blocks(num_blocks);
+    TouchingTriangles             out;
+    out.offsets.assign(m_triangles.size() + 1, 0);
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_blocks), [this, &neighbors = std::as_const(neighbors), &neighbors_propagated = std::as_const(neighbors_propagated), &blocks, &out](const tbb::blocked_range<int> &range) {
+        for (int block_idx = range.begin(); block_idx < range.end(); ++block_idx) {
+            const int facet_end = std::min(int(m_triangles.size()), (block_idx + 1) * block_size);
+            for (int facet_idx = block_idx * block_size; facet_idx < facet_end; ++facet_idx) {
+                if (const Triangle &tr = m_triangles[facet_idx]; tr.valid() && !tr.is_split())
+                    this->append_all_touching_triangles(facet_idx, neighbors[facet_idx], neighbors_propagated[facet_idx], blocks[block_idx]);
+                // Number of triangles touching facet_idx, converted to offsets below.
+                out.offsets[facet_idx + 1] = int(blocks[block_idx].size());
+            }
+        }
+    });
+
+    for (int block_idx = 0, block_offset = 0; block_idx < num_blocks; ++block_idx) {
+        const int facet_end = std::min(int(m_triangles.size()), (block_idx + 1) * block_size);
+        for (int facet_idx = block_idx * block_size; facet_idx < facet_end; ++facet_idx)
+            out.offsets[facet_idx + 1] += block_offset;
+        block_offset += int(blocks[block_idx].size());
+    }
+
+    out.triangles.resize(out.offsets.back());
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_blocks), [&blocks, &out](const tbb::blocked_range<int> &range) {
+        for (int block_idx = range.begin(); block_idx < range.end(); ++block_idx)
+            std::copy(blocks[block_idx].begin(), blocks[block_idx].end(), out.triangles.begin() + out.offsets[block_idx * block_size]);
+    });
+
+    return out;
 }
 
 void TriangleSelector::bucket_fill_select_triangles(const Vec3f &hit, int facet_start, const ClippingPlane &clp,
@@ -598,48 +639,77 @@ void TriangleSelector::bucket_fill_select_triangles(const Vec3f &hit, int facet_
 
     const float facet_angle_limit = std::cos(Geometry::deg2rad(bucket_fill_angle)) - EPSILON;
 
-    auto [neighbors, neighbors_propagated] = this->precompute_all_neighbors();
-    std::vector<bool>  visited(m_triangles.size(), false);
-    std::queue<int>    facet_queue;
+    const TouchingTriangles touching_triangles = this->collect_touching_triangles();
+    std::vector<bool>       visited(m_triangles.size(), false);
 
     // Facets that need to be checked for gap filling.
     std::vector<int> gap_fill_candidate_facets;
 
-    facet_queue.push(start_facet_idx);
-    while (!facet_queue.empty()) {
-        int current_facet = facet_queue.front();
-        facet_queue.pop();
+    // Collects the neighbors of current_facet to be filled into next_facets and the gap fill candidates into gap_facets.
+    // Only reads the triangles, thus it may be called in parallel.
+    auto expand = [this, &touching_triangles, &visited, &clp, start_facet_state, facet_angle_limit, bucket_fill_gap_area](int current_facet, std::vector<int> &next_facets, std::vector<int> &gap_facets) {
         assert(!m_triangles[current_facet].is_split());
+        auto [touching_begin, touching_end] = touching_triangles[current_facet];
+        for (const int *it = touching_begin; it != touching_end; ++it) {
+            const int tr_idx = *it;
+            if (tr_idx < 0 || visited[tr_idx] || m_triangles[tr_idx].get_state() != start_facet_state || is_facet_clipped(tr_idx, clp))
+                continue;
 
-        if (!visited[current_facet]) {
-            m_triangles[current_facet].select_by_seed_fill();
-
-            std::vector<int> touching_triangles = this->get_all_touching_triangles(current_facet, neighbors[current_facet], neighbors_propagated[current_facet]);
-            for (const int tr_idx: touching_triangles) {
-                if (tr_idx < 0 || visited[tr_idx] || m_triangles[tr_idx].get_state() != start_facet_state || is_facet_clipped(tr_idx, clp))
-                    continue;
+            // Check if neighbour_facet_idx is satisfies angle in seed_fill_angle and append it to next_facets if it do.
+            const Vec3f &n1 = m_face_normals[m_triangles[tr_idx].source_triangle];
+            const Vec3f &n2 = m_face_normals[m_triangles[current_facet].source_triangle];
+            if (std::clamp(n1.dot(n2), 0.f, 1.f) >= facet_angle_limit) {
+                assert(!m_triangles[tr_idx].is_split());
+                next_facets.emplace_back(tr_idx);
+            } else if (bucket_fill_gap_area > 0. && get_triangle_area(m_triangles[tr_idx]) <= bucket_fill_gap_area) {
+                gap_facets.emplace_back(tr_idx);
+            }
+        }
+    };
 
-                // Check if neighbour_facet_idx is satisfies angle in seed_fill_angle and append it to facet_queue if it do.
-                const Vec3f &n1 = m_face_normals[m_triangles[tr_idx].source_triangle];
-                const Vec3f &n2 = m_face_normals[m_triangles[current_facet].source_triangle];
-                if (std::clamp(n1.dot(n2), 0.f, 1.f) >= facet_angle_limit) {
-                    assert(!m_triangles[tr_idx].is_split());
-                    facet_queue.push(tr_idx);
-                } else if (bucket_fill_gap_area > 0. && get_triangle_area(m_triangles[tr_idx]) <= bucket_fill_gap_area) {
-                    gap_fill_candidate_facets.emplace_back(tr_idx);
-                }
+    // Breadth-first traversal, one front at a time. Large fronts are expanded in parallel.
+    // The set of the filled facets does not depend on the order, in which a front is expanded.
+    std::vector<int> front { start_facet_idx };
+    std::vector<int> next_front;
+    std::vector<int> candidates;
+    tbb::enumerable_thread_specific<std::pair<std::vector<int>, std::vector<int>>> thread_candidates;
+    visited[start_facet_idx] = true;
+    while (!front.empty()) {
+        for (const int facet_idx : front)
+            m_triangles[facet_idx].select_by_seed_fill();
+
+        candidates.clear();
+        if (front.size() < m_bucket_fill_parallel_front_size) {
+            for (const int facet_idx : front)
+                expand(facet_idx, candidates, gap_fill_candidate_facets);
+        } else {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, front.size(), 256), [&front, &expand, &thread_candidates](const tbb::blocked_range<size_t> &range) {
+                auto &[next_facets, gap_facets] = thread_candidates.local();
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                    expand(front[i], next_facets, gap_facets);
+            });
+            for (auto &[next_facets, gap_facets] : thread_candidates) {
+                append(candidates, std::move(next_facets));
+                append(gap_fill_candidate_facets, std::move(gap_facets));
+                next_facets.clear();
+                gap_facets.clear();
             }
         }
 
-        visited[current_facet] = true;
+        next_front.clear();
+        for (const int facet_idx : candidates)
+            if (!visited[facet_idx]) {
+                visited[facet_idx] = true;
+                next_front.emplace_back(facet_idx);
+            }
+        front.swap(next_front);
     }
 
-    bucket_fill_fill_gaps(gap_fill_candidate_facets, bucket_fill_gap_area, start_facet_state, neighbors, neighbors_propagated);
+    bucket_fill_fill_gaps(gap_fill_candidate_facets, bucket_fill_gap_area, start_facet_state, touching_triangles);
 }
 
 void TriangleSelector::bucket_fill_fill_gaps(const std::vector<int> &gap_fill_candidate_facets, const float bucket_fill_gap_area,
-                                             const TriangleStateType start_facet_state, const std::vector<Vec3i> &neighbors,
-                                             const std::vector<Vec3i> &neighbors_propagated) {
+                                             const TriangleStateType start_facet_state, const TouchingTriangles &touching_triangles) {
     std::vector<bool> visited(m_triangles.size(), false);
 
     for (const int starting_facet_idx: gap_fill_candidate_facets) {
@@ -690,8 +760,9 @@ void TriangleSelector::bucket_fill_fill_gaps(const std::vector<int> &gap_fill_ca
 
             gap_facets.emplace_back(current_facet_idx);
 
-            std::vector<int> touching_triangles = this->get_all_touching_triangles(current_facet_idx, neighbors[current_facet_idx], neighbors_propagated[current_facet_idx]);
-            for (const int tr_idx: touching_triangles) {
+            auto [touching_begin, touching_end] = touching_triangles[current_facet_idx];
+            for (const int *it = touching_begin; it != touching_end; ++it) {
+                const int tr_idx = *it;
                 if (tr_idx < 0 || visited[tr_idx] || m_triangles[tr_idx].get_state() != start_facet_state || m_triangles[tr_idx].is_selected_by_seed_fill())
                     continue;
 
@@ -505,6 +505,27 @@ protected:
     // Single triangle selected by seed fill. It is used to optimize painting using a single triangle brush.
     int m_triangle_selected_by_seed_fill = -1;
 
+    // Fronts of the bucket fill with at least this number of triangles are expanded in parallel.
+    size_t m_bucket_fill_parallel_front_size = 1024;
+
+    // Leaf triangles touching each leaf triangle, stored compactly as one array indexed by offsets.
+    // Built by bucket fill for a single fill only, thus it does not occupy memory between the fills.
+    struct TouchingTriangles {
+        std::vector<int> triangles;
+        std::vector<int> offsets;
+
+        // Leaf triangles touching the given leaf triangle.
+        std::pair<const int*, const int*> operator[](int facet_idx) const {
+            assert(facet_idx >= 0 && facet_idx + 1 < int(offsets.size()));
+            return { triangles.data() + offsets[facet_idx], triangles.data() + offsets[facet_idx + 1] };
+        }
+    };
+
+    // Appends all triangles that are touching the given facet.
+    void append_all_touching_triangles(int facet_idx, const Vec3i &neighbors, const Vec3i &neighbors_propagated, std::vector<int> &touching_triangles_out) const;
+    // Collects the triangles touching all the leaf triangles in parallel.
+    TouchingTriangles collect_touching_triangles() const;
+
     // Private functions:
 private:
     bool select_triangle(int facet_idx, TriangleStateType type, bool triangle_splitting);
@@ -535,9 +556,6 @@ private:
     void append_touching_subtriangles(int itriangle, int vertexi, int vertexj, std::vector<int> &touching_subtriangles_out) const;
     void append_touching_edges(int itriangle, int vertexi, int vertexj, std::vector<Vec2i> &touching_edges_out) const;
 
-    // Returns all triangles that are touching the given facet.
-    std::vector<int> get_all_touching_triangles(int facet_idx, const Vec3i &neighbors, const Vec3i &neighbors_propagated) const;
-
     // Check if the triangle index is the original triangle from mesh, or it was additionally created by splitting.
     bool is_original_triangle(int triangle_idx) const { return triangle_idx < m_orig_size_indices; }
 
@@ -567,8 +585,7 @@ private:
     void bucket_fill_fill_gaps(const std::vector<int>   &gap_fill_candidate_facets, // Facet of the mesh (unsplit), which needs to be checked if the surrounding gap can be filled (selected).
                                float                     bucket_fill_gap_area,      // The maximal area that will be automatically selected when the surrounding triangles have already been selected.
                                TriangleStateType         start_facet_state,         // The state of the starting facet that determines which neighbors to consider.
-                               const std::vector<Vec3i> &neighbors,
-                               const std::vector<Vec3i> &neighbors_propagate);
+                               const TouchingTriangles  &touching_triangles);
 
     int m_free_triangles_head { -1 };
     int m_free_vertices_head { -1 };
@@ -881,6 +881,9 @@ void ViewerImpl::reset()
     m_enabled_options_count = 0;
 
     m_settings_used_for_ranges = std::nullopt;
+    m_visible_segments.clear();
+    m_visible_options.clear();
+    m_settings_used_for_visible_entities = std::nullopt;
 
     delete_textures(m_enabled_options_tex_id);
     delete_buffers(m_enabled_options_buf_id);
@@ -1042,22 +1045,28 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
 
     // buffers to send to gpu
     // the last component is a dummy float to comply with GL_RGBA32F format
+    // the buffers are extracted one after the other and released as soon as they are sent to gpu,
+    // so that only one of them is held in memory together with m_vertices
     std::vector<Vec4> positions;
-    std::vector<Vec4> heights_widths_angles;
-    positions.reserve(m_vertices.size());
-    heights_widths_angles.reserve(m_vertices.size());
-    extract_pos_and_or_hwa(m_vertices, m_travels_radius, m_wipes_radius, m_valid_lines_bitset, &positions, &heights_widths_angles, true);
+    extract_pos_and_or_hwa(m_vertices, m_travels_radius, m_wipes_radius, m_valid_lines_bitset, &positions, nullptr, true);
+    // uses the valid lines bitset updated while extracting the positions
+    auto extract_heights_widths_angles = [this]() {
+        std::vector<Vec4> heights_widths_angles;
+        extract_pos_and_or_hwa(m_vertices, m_travels_radius, m_wipes_radius, m_valid_lines_bitset, nullptr, &heights_widths_angles);
+        return heights_widths_angles;
+    };
 
     if (!positions.empty()) {
 #ifdef ENABLE_OPENGL_ES
         m_texture_data.init(positions.size());
         // create and fill position textures
         m_texture_data.set_positions(positions);
+        positions = std::vector<Vec4>();
         // create and fill height, width and angle textures
-        m_texture_data.set_heights_widths_angles(heights_widths_angles);
+        m_texture_data.set_heights_widths_angles(extract_heights_widths_angles());
 #else
         m_positions_tex_size = positions.size() * sizeof(Vec3);
-        m_height_width_angle_tex_size = heights_widths_angles.size() * sizeof(Vec3);
+        m_height_width_angle_tex_size = positions.size() * sizeof(Vec3);
 
         int old_bound_texture = 0;
         glsafe(glGetIntegerv(GL_TEXTURE_BINDING_BUFFER, &old_bound_texture));
@@ -1068,11 +1077,15 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
         glsafe(glBufferData(GL_TEXTURE_BUFFER, positions.size() * sizeof(Vec4), positions.data(), GL_STATIC_DRAW));
         glsafe(glGenTextures(1, &m_positions_tex_id));
         glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_positions_tex_id));
+        positions = std::vector<Vec4>();
 
         // create and fill height, width and angles buffer
-        glsafe(glGenBuffers(1, &m_heights_widths_angles_buf_id));
-        glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_heights_widths_angles_buf_id));
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, heights_widths_angles.size() * sizeof(Vec4), heights_widths_angles.data(), GL_DYNAMIC_DRAW));
+        {
+            const std::vector<Vec4> heights_widths_angles = extract_heights_widths_angles();
+            glsafe(glGenBuffers(1, &m_heights_widths_angles_buf_id));
+            glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_heights_widths_angles_buf_id));
+            glsafe(glBufferData(GL_TEXTURE_BUFFER, heights_widths_angles.size() * sizeof(Vec4), heights_widths_angles.data(), GL_DYNAMIC_DRAW));
+        }
         glsafe(glGenTextures(1, &m_heights_widths_angles_tex_id));
         glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_heights_widths_angles_tex_id));
 
@@ -1110,8 +1123,6 @@ void ViewerImpl::update_enabled_entities()
     if (m_vertices.empty())
         return;
 
-    std::vector<uint32_t> enabled_segments;
-    std::vector<uint32_t> enabled_options;
     Interval range = m_view_range.get_visible();
 
     // when top layer only visualization is enabled, we need to render
@@ -1131,7 +1142,59 @@ void ViewerImpl::update_enabled_entities()
             --range[0];
     }
 
-    for (size_t i = range[0]; i < range[1]; ++i) {
+    update_visible_entities();
+    // the entities enabled in the range are contiguous subranges of the visible ones
+    auto in_range = [&range](const std::vector<uint32_t>& ids) {
+        return std::make_pair(std::lower_bound(ids.begin(), ids.end(), range[0]), std::lower_bound(ids.begin(), ids.end(), range[1]));
+    };
+    const auto [segments_begin, segments_end] = in_range(m_visible_segments);
+    const auto [options_begin, options_end] = in_range(m_visible_options);
+    const size_t enabled_segments_count = std::distance(segments_begin, segments_end);
+    const size_t enabled_options_count = std::distance(options_begin, options_end);
+
+#ifdef ENABLE_OPENGL_ES
+    m_texture_data.set_enabled_segments(std::vector<uint32_t>(segments_begin, segments_end));
+    m_texture_data.set_enabled_options(std::vector<uint32_t>(options_begin, options_end));
+#else
+    m_enabled_segments_count = enabled_segments_count;
+    m_enabled_options_count = enabled_options_count;
+
+    m_enabled_segments_tex_size = enabled_segments_count * sizeof(uint32_t);
+    m_enabled_options_tex_size = enabled_options_count * sizeof(uint32_t);
+
+    // update gpu buffer for enabled segments
+    assert(m_enabled_segments_buf_id > 0);
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_segments_buf_id));
+    if (enabled_segments_count > 0)
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_segments_count * sizeof(uint32_t), &*segments_begin, GL_STATIC_DRAW));
+    else
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
+
+    // update gpu buffer for enabled options
+    assert(m_enabled_options_buf_id > 0);
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_options_buf_id));
+    if (enabled_options_count > 0)
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_options_count * sizeof(uint32_t), &*options_begin, GL_STATIC_DRAW));
+    else
+        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
+
+    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+#endif // ENABLE_OPENGL_ES
+
+    m_settings.update_enabled_entities = false;
+}
+
+void ViewerImpl::update_visible_entities()
+{
+    // The visible entities only depend on the visibility settings, they are collected again only if those changed.
+    if (m_settings_used_for_visible_entities.has_value() &&
+        m_settings.extrusion_roles_visibility == m_settings_used_for_visible_entities->extrusion_roles_visibility &&
+        m_settings.options_visibility == m_settings_used_for_visible_entities->options_visibility)
+        return;
+
+    m_visible_segments.clear();
+    m_visible_options.clear();
+    for (size_t i = 0; i < m_vertices.size(); ++i) {
         const PathVertex& v = m_vertices[i];
 
         if (!m_valid_lines_bitset[i] && !v.is_option())
@@ -1156,41 +1219,12 @@ void ViewerImpl::update_enabled_entities()
             continue;
 
         if (v.is_option())
-            enabled_options.push_back(static_cast<uint32_t>(i));
+            m_visible_options.push_back(static_cast<uint32_t>(i));
         else
-            enabled_segments.push_back(static_cast<uint32_t>(i));
+            m_visible_segments.push_back(static_cast<uint32_t>(i));
     }
 
-#ifdef ENABLE_OPENGL_ES
-    m_texture_data.set_enabled_segments(enabled_segments);
-    m_texture_data.set_enabled_options(enabled_options);
-#else
-    m_enabled_segments_count = enabled_segments.size();
-    m_enabled_options_count = enabled_options.size();
-
-    m_enabled_segments_tex_size = enabled_segments.size() * sizeof(uint32_t);
-    m_enabled_options_tex_size = enabled_options.size() * sizeof(uint32_t);
-
-    // update gpu buffer for enabled segments
-    assert(m_enabled_segments_buf_id > 0);
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_segments_buf_id));
-    if (!enabled_segments.empty())
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_segments.size() * sizeof(uint32_t), enabled_segments.data(), GL_STATIC_DRAW));
-    else
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
-
-    // update gpu buffer for enabled options
-    assert(m_enabled_options_buf_id > 0);
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_options_buf_id));
-    if (!enabled_options.empty())
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_options.size() * sizeof(uint32_t), enabled_options.data(), GL_STATIC_DRAW));
-    else
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
-
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
-#endif // ENABLE_OPENGL_ES
-
-    m_settings.update_enabled_entities = false;
+    m_settings_used_for_visible_entities = m_settings;
 }
 
 static float encode_color(const Color& color) {
@@ -1613,6 +1647,8 @@ size_t ViewerImpl::get_used_cpu_memory() const
     ret += sizeof(m_options_colors);
     ret += STDVEC_MEMSIZE(m_vertices, PathVertex);
     ret += m_valid_lines_bitset.size_in_bytes_cpu();
+    ret += STDVEC_MEMSIZE(m_visible_segments, uint32_t);
+    ret += STDVEC_MEMSIZE(m_visible_options, uint32_t);
     ret += m_height_range.size_in_bytes_cpu();
     ret += m_width_range.size_in_bytes_cpu();
     ret += m_speed_range.size_in_bytes_cpu();
@@ -276,6 +276,13 @@ private:
     //
     BitSet<> m_valid_lines_bitset;
     //
+    // Indices of the segments and of the options made visible by the visibility settings, sorted by vertex id,
+    // so that a change of the view range only selects their subranges instead of scanning the vertices
+    //
+    std::vector<uint32_t> m_visible_segments;
+    std::vector<uint32_t> m_visible_options;
+    std::optional<Settings> m_settings_used_for_visible_entities;
+    //
     // Variables used for toolpaths coloring
     //
     std::optional<Settings> m_settings_used_for_ranges;
@@ -451,6 +458,7 @@ private:
 #endif // ENABLE_OPENGL_ES
 
     void update_view_full_range();
+    void update_visible_entities();
     void update_color_ranges();
     void update_heights_widths();
     void render_segments(const Mat4x4& view_matrix, const Mat4x4& projection_matrix, const Vec3& camera_position);
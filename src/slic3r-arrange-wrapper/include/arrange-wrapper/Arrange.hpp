@@ -19,6 +19,12 @@ public:
     class Ctl : public ArrangeTaskCtl {
     public:
         virtual void on_packed(ArrItem &item) {};
+
+        // The arranger may try several item orders in parallel and report
+        // on_packed() only for the run with the best result, after all the
+        // runs have finished. A controller steering the arrangement from
+        // on_packed() has to return false here.
+        virtual bool allow_multistart() const { return true; }
     };
 
     virtual ~Arranger() = default;
@@ -30,6 +30,7 @@
 #include <arrange/PackingContext.hpp>
 #include <arrange/NFP/NFPArrangeItemTraits.hpp>
 #include <arrange/NFP/NFP.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeItemTraits.hpp>
 #include <arrange/DataStoreTraits.hpp>
@@ -63,6 +64,7 @@ inline bool check_polygons_are_convex(const Polygons &pp) {
 class DecomposedShape
 {
     Polygons m_shape;
+    size_t   m_contours_hash = 0; // Identifies the untransformed shape
 
     Vec2crd m_translation{0, 0}; // The translation of the poly
     double  m_rotation{0.0};     // The rotation of the poly in radians
@@ -88,6 +90,7 @@ public:
     explicit DecomposedShape(Polygon sh)
     {
         m_shape.emplace_back(std::move(sh));
+        m_contours_hash = hash_contours(m_shape);
         assert(check_polygons_are_convex(m_shape));
     }
 
@@ -97,11 +100,17 @@ public:
 
     explicit DecomposedShape(Polygons sh) : m_shape{std::move(sh)}
     {
+        m_contours_hash = hash_contours(m_shape);
         assert(check_polygons_are_convex(m_shape));
     }
 
     const Polygons &contours() const { return m_shape; }
 
+    // Hash of the untransformed contours. Shapes with the same hash and
+    // the same rotation only differ in their translation.
+    size_t contours_hash() const { return m_contours_hash; }
+    static size_t hash_contours(const Polygons &contours);
+
     const Vec2crd &translation() const { return m_translation; }
     double         rotation() const { return m_rotation; }
 
@@ -313,7 +322,8 @@ template<> struct WritableDataStoreTraits_<ArrangeItem>
 template<class FixedIt, class StopCond = DefaultStopCondition>
 static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
                                            const Range<FixedIt> &fixed_items,
-                                           StopCond &&stop_cond = {})
+                                           StopCond &&stop_cond = {},
+                                           NFPCache *cache = nullptr)
 {
     size_t cap = 0;
 
@@ -334,18 +344,33 @@ static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
         // as ArrangeItem stores convex-decomposed polygons
         const Polygons & fixed_polys = fixed.shape().transformed_outline();
 
-        for (const Polygon &fixed_poly : fixed_polys) {
+        for (size_t fi = 0; fi < fixed_polys.size(); ++fi) {
+            const Polygon &fixed_poly = fixed_polys[fi];
             Point max_fixed = Slic3r::reference_vertex(fixed_poly);
             for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
                 const Polygon &movable = item_outlines[mi];
                 const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+
+                NFPCache::Key key{fixed.shape().contours_hash(),
+                                  fixed.shape().rotation(), fi,
+                                  item.envelope().contours_hash(),
+                                  item.envelope().rotation(), mi};
+
+                const Polygon &fixed_contour   = fixed.shape().contours()[fi];
+                const Polygon &movable_contour = item.envelope().contours()[mi];
+
+                Vec2crd max_nfp;
+                if (!cache || !cache->find(key, fixed_contour, movable_contour, subnfp, max_nfp)) {
+                    subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+                    max_nfp = Slic3r::reference_vertex(subnfp);
+                    if (cache)
+                        cache->insert(key, fixed_contour, movable_contour, subnfp, max_nfp);
+                }
 
                 Vec2crd min_movable = item.envelope().min_vertex(mi);
 
                 Vec2crd dtouch = max_fixed - min_movable;
                 Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
                 auto dnfp = top_other - max_nfp;
 
                 auto d = ref_whole - mref + dnfp;
@@ -375,8 +400,13 @@ template<> struct NFPArrangeItemTraits_<ArrangeItem> {
                                     const Bed &bed,
                                     StopCond &&stopcond)
     {
+        // The cache can be shared among the items of an arrangement
+        // through their datastore.
+        auto cache = get_data<std::shared_ptr<NFPCache>>(item, "nfp_cache");
+
         auto static_items = all_items_range(packing_context);
-        Polygons nfps = arr2::calculate_nfp_unnormalized(item, static_items, stopcond);
+        Polygons nfps = arr2::calculate_nfp_unnormalized(item, static_items, stopcond,
+                                                         cache ? cache->get() : nullptr);
 
         ExPolygons nfp_ex;
 
@@ -200,7 +200,7 @@ struct MutableItemTraits_<SimpleArrangeItem> {
     }
 
     template<class T>
-    static void set_data(SimpleArrangeItem &itm, const std::string &key, T &&data)
+    static void set_arbitrary_data(SimpleArrangeItem &itm, const std::string &key, T &&data)
     {}
 
     static void set_allowed_rotations(SimpleArrangeItem &itm, const std::vector<double> &rotations)
@@ -7,6 +7,11 @@
 
 #include <random>
 #include <map>
+#include <chrono>
+#include <tuple>
+#include <memory>
+#include <atomic>
+#include <limits>
 
 #include <libslic3r/Execution/ExecutionTBB.hpp>
 #include <libslic3r/Geometry/ConvexHull.hpp>
@@ -14,6 +19,7 @@
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeFirstFit.hpp>
 #include <arrange/NFP/PackStrategyNFP.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 #include <arrange/NFP/Kernels/TMArrangeKernel.hpp>
 #include <arrange/NFP/Kernels/GravityKernel.hpp>
 #include <arrange/NFP/RectangleOverfitPackingStrategy.hpp>
@@ -256,41 +262,72 @@ void fill_rotations(const Range<It>           &items,
     }
 }
 
-// An arranger put together to fulfill all the requirements of PrusaSlicer based
-// on the supplied ArrangeSettings
-template<class ArrItem>
-class DefaultArranger: public Arranger<ArrItem> {
-    ArrangeSettings m_settings;
-
-    static constexpr auto Accuracy = 1.;
+// Quality of a finished arrangement, used to pick the best one out of
+// the multi-start runs. Less unarranged items come first, then less beds and
+// finally the smaller total area of the piles of items on the beds.
+struct ArrangementScore
+{
+    size_t unarranged = 0;
+    int    beds       = 0;
+    double pile_area  = 0.;
 
-    template<class It, class FixIt, class Bed>
-    void arrange_(
-        const Range<It>     &items,
-        const Range<FixIt>  &fixed,
-        const Bed &bed,
-        ArrangerCtl<ArrItem> &ctl)
+    bool operator<(const ArrangementScore &other) const
     {
-        auto cmpfn = [](const auto &itm1, const auto &itm2) {
-            int pa = get_priority(itm1);
-            int pb = get_priority(itm2);
+        return std::tie(unarranged, beds, pile_area) <
+               std::tie(other.unarranged, other.beds, other.pile_area);
+    }
+};
 
-            return pa == pb ? area(envelope_convex_hull(itm1)) > area(envelope_convex_hull(itm2)) :
-                              pa > pb;
-        };
+template<class Cont>
+ArrangementScore arrangement_score(const Cont &items)
+{
+    ArrangementScore ret;
+    std::map<int, BoundingBox> piles;
 
-        auto on_arranged = [&ctl](auto &itm, auto &bed, auto &ctx, auto &rem) {
-            ctl.update_status(rem.size());
+    for (auto &itm : items) {
+        int bedidx = get_bed_index(itm);
+        if (bedidx < 0)
+            ++ret.unarranged;
+        else
+            piles[bedidx].merge(fixed_bounding_box(itm));
+    }
 
-            ctl.on_packed(itm);
+    for (auto &[bedidx, pilebb] : piles) {
+        Vec2d sz = unscaled(pilebb).size();
+        ret.beds = std::max(ret.beds, bedidx + 1);
+        ret.pile_area += sz.x() * sz.y();
+    }
 
-            firstfit::DefaultOnArrangedFn{}(itm, bed, ctx, rem);
-        };
+    return ret;
+}
 
-        auto stop_cond = [&ctl] { return ctl.was_canceled(); };
+// An arranger put together to fulfill all the requirements of PrusaSlicer based
+// on the supplied ArrangeSettings
+template<class ArrItem>
+class DefaultArranger: public Arranger<ArrItem> {
+    ArrangeSettings m_settings;
 
-        firstfit::SelectionStrategy sel{cmpfn, on_arranged, stop_cond};
+    static constexpr auto Accuracy = 1.;
 
+    // Maximum number of arrangements with different item orders and
+    // rotations tried in parallel. The first run uses the default order and
+    // always finishes. The others are given MultiStartTimeSlack times the
+    // duration of the first run to finish, then they are abandoned.
+    static constexpr size_t MaxStarts = 8;
+    static constexpr double MultiStartTimeSlack = 0.5;
+
+    // Seed of the perturbations of the multi-start runs, the results have to
+    // be reproducible.
+    static constexpr std::mt19937::result_type MultiStartSeed = 5489u;
+
+    template<class It, class FixIt, class Bed, class Sel, class StopCond>
+    void pack_items(Sel                 &sel,
+                    const Range<It>     &items,
+                    const Range<FixIt>  &fixed,
+                    const Bed           &bed,
+                    StopCond             stop_cond,
+                    size_t               start = 0)
+    {
         constexpr auto ep = ex_tbb;
 
         VariantKernel basekernel;
@@ -310,13 +347,14 @@ class DefaultArranger: public Arranger<ArrItem> {
         }
 
 #ifndef NDEBUG
-        SVGDebugOutputKernelWrapper<VariantKernel> kernel{bounding_box(bed), basekernel};
+        // The multi-start runs write their debug output into separate files.
+        std::string svgname = start == 0 ? std::string("arrange") :
+                                           "arrange_start" + std::to_string(start);
+        SVGDebugOutputKernelWrapper<VariantKernel> kernel{bounding_box(bed), basekernel, svgname};
 #else
         auto & kernel = basekernel;
 #endif
 
-        fill_rotations(items, bed, m_settings);
-
         bool with_wipe_tower = std::any_of(items.begin(), items.end(),
                                            [](auto &itm) {
                                                return is_wipe_tower(itm);
@@ -340,6 +378,205 @@ class DefaultArranger: public Arranger<ArrItem> {
         }
     }
 
+    // Runs the arrangement of copies of the items in parallel, each with
+    // a differently perturbed item order, every second one also with a random
+    // subset of the allowed rotations. The perturbations are seeded by the
+    // index of the run, thus they are the same on each call. The
+    // transformations of the best finished run are copied back to the items
+    // and the callbacks of ctl are replayed in its packing order.
+    template<class It, class FixIt, class Bed, class CmpFn>
+    void arrange_multistart(const Range<It>      &items,
+                            const Range<FixIt>   &fixed,
+                            const Bed            &bed,
+                            ArrangerCtl<ArrItem> &ctl,
+                            CmpFn                 cmpfn,
+                            size_t                starts)
+    {
+        struct Start
+        {
+            std::vector<ArrItem> items;
+            std::vector<double>  area_keys;
+            std::vector<size_t>  packing_order;
+            ArrangementScore     score;
+            bool                 finished = false;
+        };
+
+        // The fixed items are shared by the runs, their cached geometry has
+        // to be ready before they are read concurrently.
+        for (auto &fitm : fixed) {
+            fixed_outline(fitm);
+            fixed_convex_hull(fitm);
+            fixed_bounding_box(fitm);
+            fixed_centroid(fitm);
+            envelope_outline(fitm);
+            envelope_convex_hull(fitm);
+            envelope_centroid(fitm);
+            reference_vertex(fitm);
+        }
+
+        std::vector<Start> runs(starts);
+        for (size_t s = 0; s < starts; ++s) {
+            Start &run = runs[s];
+            run.items.assign(items.begin(), items.end());
+
+            if (s == 0)
+                continue;
+
+            // The output of std::mt19937 is fully specified by the standard,
+            // unlike the output of the std distributions.
+            std::mt19937 rng(MultiStartSeed + s);
+            auto noise = [&rng] {
+                return 0.7 + 0.6 * double(rng() - rng.min()) / double(rng.max() - rng.min());
+            };
+            auto keep_rotation = [&rng] { return (rng() & 1) != 0; };
+
+            run.area_keys.reserve(run.items.size());
+            for (ArrItem &itm : run.items) {
+                run.area_keys.emplace_back(area(envelope_convex_hull(itm)) * noise());
+
+                if (s % 2 == 0)
+                    continue;
+
+                const auto &rotations = allowed_rotations(itm);
+                std::vector<double> subset;
+                for (auto rot_it = rotations.begin(); rot_it != rotations.end(); ++rot_it)
+                    if (rot_it == rotations.begin() || keep_rotation())
+                        subset.emplace_back(*rot_it);
+
+                set_allowed_rotations(itm, subset);
+            }
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        // Set when the run with the default order finishes, the other runs
+        // are cancelled once it passes.
+        const auto start_time = Clock::now();
+        std::atomic<Clock::rep> deadline{std::numeric_limits<Clock::rep>::max()};
+
+        execution::for_each(ex_tbb, size_t(0), starts, [&](size_t s) {
+            Start &run = runs[s];
+
+            auto idx = [&run](const ArrItem &itm) {
+                return size_t(&itm - run.items.data());
+            };
+
+            auto run_cmpfn = [&run, &cmpfn, &idx, s](const auto &itm1, const auto &itm2) {
+                if (s == 0)
+                    return cmpfn(itm1, itm2);
+
+                int pa = get_priority(itm1);
+                int pb = get_priority(itm2);
+
+                return pa == pb ? run.area_keys[idx(itm1)] > run.area_keys[idx(itm2)] :
+                                  pa > pb;
+            };
+
+            // Only the run with the default order reports the progress
+            auto on_arranged = [&ctl, &run, &idx, s](auto &itm, auto &, auto &, auto &rem) {
+                if (s == 0)
+                    ctl.update_status(rem.size());
+
+                run.packing_order.emplace_back(idx(itm));
+            };
+
+            auto stop_cond = [&ctl, &deadline, s] {
+                return ctl.was_canceled() ||
+                       (s > 0 && Clock::now().time_since_epoch().count() > deadline.load(std::memory_order_relaxed));
+            };
+
+            firstfit::SelectionStrategy sel{run_cmpfn, on_arranged, stop_cond};
+
+            pack_items(sel, range(run.items), fixed, bed, stop_cond, s);
+
+            run.finished = !stop_cond();
+            run.score    = arrangement_score(run.items);
+
+            if (s == 0) {
+                auto now = Clock::now();
+                auto slack = std::chrono::duration_cast<Clock::duration>((now - start_time) * MultiStartTimeSlack);
+                deadline.store((now + slack).time_since_epoch().count(), std::memory_order_relaxed);
+            }
+        });
+
+        // Ties are broken by the index of the run, thus the default order
+        // wins them. It also wins when the arrangement was cancelled.
+        const Start *best = &runs.front();
+        for (const Start &run : runs)
+            if (run.finished && best->finished && run.score < best->score)
+                best = &run;
+
+        std::vector<std::reference_wrapper<ArrItem>> order;
+        order.reserve(best->packing_order.size());
+
+        auto it = items.begin();
+        for (const ArrItem &itm : best->items) {
+            set_translation(*it, get_translation(itm));
+            set_rotation(*it, get_rotation(itm));
+            set_bed_index(*it, get_bed_index(itm));
+            ++it;
+        }
+
+        for (size_t i : best->packing_order)
+            order.emplace_back(*std::next(items.begin(), i));
+
+        for (size_t k = 0; k < order.size(); ++k) {
+            auto packed    = Range{order.cbegin(), order.cbegin() + k};
+            auto remaining = Range{order.cbegin() + k + 1, order.cend()};
+
+            ctl.on_packed(order[k]);
+            firstfit::DefaultOnArrangedFn{}(order[k], bed, packed, remaining);
+        }
+    }
+
+    template<class It, class FixIt, class Bed>
+    void arrange_(
+        const Range<It>     &items,
+        const Range<FixIt>  &fixed,
+        const Bed &bed,
+        ArrangerCtl<ArrItem> &ctl)
+    {
+        auto cmpfn = [](const auto &itm1, const auto &itm2) {
+            int pa = get_priority(itm1);
+            int pb = get_priority(itm2);
+
+            return pa == pb ? area(envelope_convex_hull(itm1)) > area(envelope_convex_hull(itm2)) :
+                              pa > pb;
+        };
+
+        fill_rotations(items, bed, m_settings);
+
+        // No-fit polygons of the same pairs of shapes and rotations are
+        // needed many times, the cache is shared by all the items.
+        auto nfp_cache = std::make_shared<NFPCache>();
+        for (auto &itm : items)
+            set_arbitrary_data(itm, "nfp_cache", nfp_cache);
+
+        size_t starts = std::min(MaxStarts, execution::max_concurrency(ex_tbb));
+        if (starts > 1 && items.size() > 2 && ctl.allow_multistart()) {
+            arrange_multistart(items, fixed, bed, ctl, cmpfn, starts);
+        } else {
+            auto on_arranged = [&ctl](auto &itm, auto &bed, auto &ctx, auto &rem) {
+                ctl.update_status(rem.size());
+
+                ctl.on_packed(itm);
+
+                firstfit::DefaultOnArrangedFn{}(itm, bed, ctx, rem);
+            };
+
+            auto stop_cond = [&ctl] { return ctl.was_canceled(); };
+
+            firstfit::SelectionStrategy sel{cmpfn, on_arranged, stop_cond};
+
+            pack_items(sel, items, fixed, bed, stop_cond);
+        }
+
+        // The cached no-fit polygons are not valid for another arrangement,
+        // release them with the items.
+        for (auto &itm : items)
+            set_arbitrary_data(itm, "nfp_cache", std::shared_ptr<NFPCache>{});
+    }
+
 public:
     explicit DefaultArranger(const ArrangeSettingsView &settings)
     {
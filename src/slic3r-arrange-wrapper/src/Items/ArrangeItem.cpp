@@ -5,6 +5,8 @@
 
 #include <numeric>
 
+#include <boost/functional/hash.hpp>
+
 #include <libslic3r/Geometry/ConvexHull.hpp>
 #include <arrange/NFP/NFPConcave_Tesselate.hpp>
 
@@ -16,6 +18,20 @@
 
 namespace Slic3r { namespace arr2 {
 
+size_t DecomposedShape::hash_contours(const Polygons &contours)
+{
+    size_t seed = contours.size();
+    for (const Polygon &poly : contours) {
+        boost::hash_combine(seed, poly.size());
+        for (const Point &p : poly.points) {
+            boost::hash_combine(seed, p.x());
+            boost::hash_combine(seed, p.y());
+        }
+    }
+
+    return seed;
+}
+
 const Polygons &DecomposedShape::transformed_outline() const
 {
     constexpr auto sc = scaled<double>(1.) * scaled<double>(1.);
@@ -180,6 +180,8 @@ std::unique_ptr<FillBedTaskResult> FillBedTask<ArrItem>::process_native(
             do_stop = get_bed_index(itm) == -1 && get_priority(itm) == 0;
         }
 
+        bool allow_multistart() const override { return false; }
+
     } subctl(ctl, *this);
 
     auto arranger = Arranger<ArrItem>::create(settings);
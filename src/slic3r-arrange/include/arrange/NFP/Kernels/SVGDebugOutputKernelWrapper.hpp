@@ -22,10 +22,12 @@ struct SVGDebugOutputKernelWrapper {
     Kernel &k;
     std::unique_ptr<Slic3r::SVG> svg;
     BoundingBox drawbounds;
+    std::string name;
 
     template<class... Args>
-    SVGDebugOutputKernelWrapper(const BoundingBox &bounds, Kernel &kern)
-        : k{kern}, drawbounds{bounds}
+    SVGDebugOutputKernelWrapper(const BoundingBox &bounds, Kernel &kern,
+                                std::string name = "arrange")
+        : k{kern}, drawbounds{bounds}, name{std::move(name)}
     {}
 
     template<class ArrItem, class Bed, class Context, class RemIt>
@@ -46,7 +48,7 @@ struct SVGDebugOutputKernelWrapper {
         svg.reset();
         auto bounds = drawbounds;
         auto fixed = all_items_range(packing_context);
-        svg = std::make_unique<SVG>(std::string("arrange_bed") +
+        svg = std::make_unique<SVG>(name + "_bed" +
                                         std::to_string(
                                             arr2::get_bed_index(itm)) +
                                         "_" + std::to_string(fixed.size()) +
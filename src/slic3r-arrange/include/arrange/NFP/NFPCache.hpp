@@ -0,0 +1,78 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <stddef.h>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <libslic3r/Point.hpp>
+#include <libslic3r/Polygon.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+// Thread safe storage of the no-fit polygons of the convex parts of the
+// items. The NFP of two convex polygons depends only on their shapes, not on
+// their positions, thus it can be reused for any pair of items with the same
+// contours and rotations after translating it to the right place. The key
+// only holds hashes of the contours, thus each entry also stores the
+// untransformed contours of both parts, which are compared on a hit. The cache
+// stops growing after reaching MaxEntries to keep the memory bounded when
+// arranging many different shapes. Entries are never removed, thus lookups
+// only share the lock and copy the found entry after releasing it.
+class NFPCache
+{
+public:
+    struct Key
+    {
+        size_t fixed_shape;
+        double fixed_rotation;
+        size_t fixed_part;
+        size_t movable_shape;
+        double movable_rotation;
+        size_t movable_part;
+
+        bool operator==(const Key &k) const
+        {
+            return fixed_shape == k.fixed_shape &&
+                   fixed_rotation == k.fixed_rotation &&
+                   fixed_part == k.fixed_part &&
+                   movable_shape == k.movable_shape &&
+                   movable_rotation == k.movable_rotation &&
+                   movable_part == k.movable_part;
+        }
+    };
+
+    static constexpr size_t MaxEntries = 100000;
+
+    // Returns false if the key is not in the cache or if it was cached for
+    // different contours, otherwise sets nfp and its reference vertex to the
+    // cached values. The contours are the untransformed convex parts.
+    bool find(const Key &key, const Polygon &fixed_contour, const Polygon &movable_contour,
+              Polygon &nfp, Vec2crd &refv) const;
+    void insert(const Key &key, const Polygon &fixed_contour, const Polygon &movable_contour,
+                const Polygon &nfp, const Vec2crd &refv);
+
+    size_t size() const;
+
+private:
+    struct KeyHash { size_t operator()(const Key &k) const; };
+    struct Entry
+    {
+        Polygon fixed_contour;
+        Polygon movable_contour;
+        Polygon nfp;
+        Vec2crd refv;
+    };
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // NFPCACHE_HPP
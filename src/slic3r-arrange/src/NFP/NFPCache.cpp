@@ -0,0 +1,65 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include <arrange/NFP/NFPCache.hpp>
+
+#include <boost/functional/hash.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+size_t NFPCache::KeyHash::operator()(const Key &k) const
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, k.fixed_shape);
+    boost::hash_combine(seed, k.fixed_rotation);
+    boost::hash_combine(seed, k.fixed_part);
+    boost::hash_combine(seed, k.movable_shape);
+    boost::hash_combine(seed, k.movable_rotation);
+    boost::hash_combine(seed, k.movable_part);
+
+    return seed;
+}
+
+bool NFPCache::find(const Key &key, const Polygon &fixed_contour, const Polygon &movable_contour,
+                    Polygon &nfp, Vec2crd &refv) const
+{
+    const Entry *entry = nullptr;
+    {
+        std::shared_lock lk{m_mutex};
+
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return false;
+
+        // The elements of an unordered_map stay in place when other elements
+        // are inserted, and the entries are never modified nor removed.
+        entry = &it->second;
+    }
+
+    if (entry->fixed_contour != fixed_contour || entry->movable_contour != movable_contour)
+        return false;
+
+    nfp  = entry->nfp;
+    refv = entry->refv;
+
+    return true;
+}
+
+void NFPCache::insert(const Key &key, const Polygon &fixed_contour, const Polygon &movable_contour,
+                      const Polygon &nfp, const Vec2crd &refv)
+{
+    std::unique_lock lk{m_mutex};
+
+    if (m_entries.size() < MaxEntries)
+        m_entries.emplace(key, Entry{fixed_contour, movable_contour, nfp, refv});
+}
+
+size_t NFPCache::size() const
+{
+    std::shared_lock lk{m_mutex};
+
+    return m_entries.size();
+}
+
+}} // namespace Slic3r::arr2
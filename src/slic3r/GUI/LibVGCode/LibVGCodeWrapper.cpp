@@ -192,30 +192,43 @@ GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::ve
     }
 
     const std::vector<Slic3r::GCodeProcessorResult::MoveVertex>& moves = result.moves;
-    ret.vertices.reserve(2 * moves.size());
+    // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
+    // before the first move of a path
+    auto starts_path = [&moves](size_t i) {
+        const Slic3r::GCodeProcessorResult::MoveVertex& curr = moves[i];
+        const Slic3r::GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
+        const EOptionType option_type = move_type_to_option(convert(curr.type));
+        return (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) &&
+            (i == 1 || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role);
+    };
+
+    // count the vertices first, to allocate them exactly once: reserving for the worst case and shrinking the
+    // vector afterwards would hold the moves and two copies of the vertices in memory at the same time
+    size_t vertices_count = 0;
+    for (size_t i = 1; i < moves.size(); ++i) {
+        vertices_count += starts_path(i) ? 2 : 1;
+    }
+    ret.vertices.reserve(vertices_count);
+
     for (size_t i = 1; i < moves.size(); ++i) {
         const Slic3r::GCodeProcessorResult::MoveVertex& curr = moves[i];
         const Slic3r::GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
         const EMoveType curr_type = convert(curr.type);
-        const EOptionType option_type = move_type_to_option(curr_type);
-        if (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) {
-            if (ret.vertices.empty() || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role) {
-                // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
-                // equal to the current one with the exception of the position, which should match the previous move position,
-                // and the times, which are set to zero
+        if (starts_path(i)) {
+            // the 'phantom' vertex is equal to the current one with the exception of the position,
+            // which should match the previous move position, and the times, which are set to zero
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+            const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
+                static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
 #else
-              const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+          const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
+                static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                ret.vertices.emplace_back(vertex);
-            }
+            ret.vertices.emplace_back(vertex);
         }
 
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
@@ -232,7 +245,7 @@ GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::ve
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
         ret.vertices.emplace_back(vertex);
     }
-    ret.vertices.shrink_to_fit();
+    assert(ret.vertices.size() == vertices_count);
 
     ret.spiral_vase_mode = result.spiral_vase_mode;
 
@@ -192,6 +192,9 @@ public:
     
     const AABBMesh &get_aabb_mesh() const { return m_emesh; }
 
+    // Bounding box of the mesh in mesh coords.
+    BoundingBoxf3 get_bounding_box() const { return m_mesh->bounding_box(); }
+
     // Given a point and direction in world coords, returns whether the respective line
     // intersects the mesh if it is transformed into world by trafo.
     bool intersects_line(Vec3d point, Vec3d direction, const Transform3d& trafo) const;
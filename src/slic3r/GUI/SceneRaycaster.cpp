@@ -6,6 +6,7 @@
 #include "SceneRaycaster.hpp"
 
 #include "Camera.hpp"
+#include "CameraUtils.hpp"
 #include "GUI_App.hpp"
 #include "Selection.hpp"
 #include "Plater.hpp"
@@ -15,6 +16,94 @@
 namespace Slic3r {
 namespace GUI {
 
+size_t SceneRaycasterItem::s_last_timestamp = 0;
+
+bool SceneRaycasterTree::update(const std::vector<std::shared_ptr<SceneRaycasterItem>>& items)
+{
+    bool changed = items.size() != m_entries.size();
+    m_entries.resize(items.size());
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        const SceneRaycasterItem* item = items[i].get();
+        Entry& entry = m_entries[i];
+        if (entry.item == item && entry.timestamp == item->get_timestamp())
+            continue;
+
+        entry.item = item;
+        entry.timestamp = item->get_timestamp();
+        entry.box.setEmpty();
+        const BoundingBoxf3 mesh_box = item->get_raycaster()->get_bounding_box();
+        if (mesh_box.defined) {
+            const BoundingBoxf3 box = mesh_box.transformed(item->get_transform());
+            // The ray-triangle intersection uses an epsilon, don't let the box cut the hits off.
+            const Vec3d eps = Vec3d::Constant(EPSILON + 0.001 * box.size().norm());
+            entry.box = { box.min - eps, box.max + eps };
+        }
+        changed = true;
+    }
+
+    if (changed) {
+        struct InputType {
+            size_t idx() const { return m_idx; }
+            const AABBTreeIndirect::Tree3d::BoundingBox& bbox() const { return m_bbox; }
+            const AABBTreeIndirect::Tree3d::VectorType& centroid() const { return m_centroid; }
+
+            size_t m_idx;
+            AABBTreeIndirect::Tree3d::BoundingBox m_bbox;
+            AABBTreeIndirect::Tree3d::VectorType m_centroid;
+        };
+
+        std::vector<InputType> input;
+        input.reserve(m_entries.size());
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            // Empty meshes can't be hit.
+            if (!m_entries[i].box.isEmpty())
+                input.push_back({ i, m_entries[i].box, m_entries[i].box.center() });
+        }
+        m_tree.build(std::move(input));
+    }
+
+    return changed;
+}
+
+void SceneRaycasterTree::candidates(const Vec3d& point, const Vec3d& direction, std::vector<size_t>& out) const
+{
+    out.clear();
+
+    // Slab test of the whole line, not only of the half-line starting at point.
+    auto crosses = [&point, &direction](const AABBTreeIndirect::Tree3d::Node& node) {
+        double t_min = -std::numeric_limits<double>::max();
+        double t_max = std::numeric_limits<double>::max();
+        for (int i = 0; i < 3; ++i) {
+            // Only an exactly parallel direction is tested separately. A tiny component still crosses the slab
+            // over a long, but finite interval of t, which has to be intersected with the other slabs.
+            if (direction[i] == 0.) {
+                if (point[i] < node.bbox.min()[i] || point[i] > node.bbox.max()[i])
+                    return false;
+            }
+            else {
+                double t1 = (node.bbox.min()[i] - point[i]) / direction[i];
+                double t2 = (node.bbox.max()[i] - point[i]) / direction[i];
+                if (t1 > t2)
+                    std::swap(t1, t2);
+                t_min = std::max(t_min, t1);
+                t_max = std::min(t_max, t2);
+                if (t_min > t_max)
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    AABBTreeIndirect::traverse(m_tree, crosses, [&out](const AABBTreeIndirect::Tree3d::Node& node) {
+        out.emplace_back(node.idx);
+        return true;
+    });
+
+    // Keep the order of the items, the hit test relies on it when resolving overlapping hits.
+    std::sort(out.begin(), out.end());
+}
+
 SceneRaycaster::SceneRaycaster() {
 #if ENABLE_RAYCAST_PICKING_DEBUG
     // hit point
@@ -157,14 +246,20 @@ SceneRaycaster::HitResult SceneRaycaster::hit(const Vec2d& mouse_pos, const Came
 
     HitResult ret;
 
-    auto test_raycasters = [this, is_closest, clipping_plane, &volume_keeper](EType type, const Vec2d& mouse_pos, const Camera& camera, HitResult& ret) {
+    // Picking ray in world coords, used to select the items whose meshes have to be tested.
+    Vec3d ray_point;
+    Vec3d ray_direction;
+    CameraUtils::ray_from_screen_pos(camera, mouse_pos, ray_point, ray_direction);
+    std::vector<size_t> candidates;
+
+    auto test_raycasters = [this, is_closest, clipping_plane, &volume_keeper, &ray_point, &ray_direction, &candidates](EType type, const Vec2d& mouse_pos, const Camera& camera, HitResult& ret) {
         const ClippingPlane* clip_plane = (clipping_plane != nullptr && type == EType::Volume) ? clipping_plane : nullptr;
         const std::vector<std::shared_ptr<SceneRaycasterItem>>* raycasters = get_raycasters(type);
         const Vec3f camera_forward = camera.get_dir_forward().cast<float>();
         HitResult current_hit = { type };
-        for (const std::shared_ptr<SceneRaycasterItem>& item : *raycasters) {
+        auto test_raycaster = [&](const std::shared_ptr<SceneRaycasterItem>& item) {
             if (!item->is_active())
-                continue;
+                return;
 
             bool sth_hit = false;
 
@@ -200,6 +295,27 @@ SceneRaycaster::HitResult SceneRaycaster::hit(const Vec2d& mouse_pos, const Came
                     }
                 }
             }
+        };
+
+        SceneRaycasterTree* tree = nullptr;
+        switch (type) {
+        case EType::Volume: { tree = &m_volumes_tree; break; }
+        case EType::Gizmo: { tree = &m_gizmos_tree; break; }
+        case EType::FallbackGizmo: { tree = &m_fallback_gizmos_tree; break; }
+        default: { break; }
+        }
+
+        if (tree != nullptr) {
+            tree->update(*raycasters);
+            tree->candidates(ray_point, ray_direction, candidates);
+            for (size_t idx : candidates) {
+                test_raycaster((*raycasters)[idx]);
+            }
+        }
+        else {
+            for (const std::shared_ptr<SceneRaycasterItem>& item : *raycasters) {
+                test_raycaster(item);
+            }
         }
     };
 
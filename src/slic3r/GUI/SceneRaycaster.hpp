@@ -7,6 +7,7 @@
 
 #include "MeshUtils.hpp"
 #include "GLModel.hpp"
+#include "libslic3r/AABBTreeIndirect.hpp"
 #include <vector>
 #include <string>
 #include <optional>
@@ -23,10 +24,14 @@ class SceneRaycasterItem
     bool m_use_back_faces{ false };
     const MeshRaycaster* m_raycaster;
     Transform3d m_trafo;
+    // Unique among all the items, changes with the transformation.
+    size_t m_timestamp;
+
+    static size_t s_last_timestamp;
 
 public:
     SceneRaycasterItem(int id, const MeshRaycaster& raycaster, const Transform3d& trafo, bool use_back_faces = false)
-        : m_id(id), m_raycaster(&raycaster), m_trafo(trafo), m_use_back_faces(use_back_faces)
+        : m_id(id), m_raycaster(&raycaster), m_trafo(trafo), m_use_back_faces(use_back_faces), m_timestamp(++s_last_timestamp)
     {}
 
     int get_id() const { return m_id; }
@@ -35,7 +40,36 @@ public:
     bool use_back_faces() const { return m_use_back_faces; }
     const MeshRaycaster* get_raycaster() const { return m_raycaster; }
     const Transform3d& get_transform() const { return m_trafo; }
-    void set_transform(const Transform3d& trafo) { m_trafo = trafo; }
+    void set_transform(const Transform3d& trafo) { m_trafo = trafo; m_timestamp = ++s_last_timestamp; }
+    size_t get_timestamp() const { return m_timestamp; }
+};
+
+// Bounding volume hierarchy over the world bounding boxes of raycaster items,
+// so that a picking ray is tested only against the meshes it may hit.
+class SceneRaycasterTree
+{
+    struct Entry
+    {
+        const SceneRaycasterItem* item{ nullptr };
+        size_t timestamp{ 0 };
+        AABBTreeIndirect::Tree3d::BoundingBox box;
+    };
+
+    std::vector<Entry> m_entries;
+    AABBTreeIndirect::Tree<3, double> m_tree;
+
+public:
+    // Synchronizes the tree with the given items. Only the bounding boxes of the items
+    // added or transformed since the last update are recalculated.
+    // Returns true if the tree had to be rebuilt.
+    bool update(const std::vector<std::shared_ptr<SceneRaycasterItem>>& items);
+
+    // Indices (into the items passed to the last update()) of the items whose bounding box
+    // is crossed by the line through the given point, in ascending order.
+    void candidates(const Vec3d& point, const Vec3d& direction, std::vector<size_t>& out) const;
+
+    size_t size() const { return m_entries.size(); }
+    void clear() { m_entries.clear(); m_tree.clear(); }
 };
 
 class SceneRaycaster
@@ -74,6 +108,11 @@ private:
     std::vector<std::shared_ptr<SceneRaycasterItem>> m_gizmos;
     std::vector<std::shared_ptr<SceneRaycasterItem>> m_fallback_gizmos;
 
+    // Updated lazily from hit(). The bed is tested for each of the multiple beds and it is not accelerated.
+    mutable SceneRaycasterTree m_volumes_tree;
+    mutable SceneRaycasterTree m_gizmos_tree;
+    mutable SceneRaycasterTree m_fallback_gizmos_tree;
+
     // When set to true, if checking gizmos returns a valid hit,
     // the search is not performed on other types
     bool m_gizmos_on_top{ false };
@@ -0,0 +1,556 @@
+///|/ Copyright (c) Prusa Research 2019 - 2022 Enrico Turri @enricoturri1966, Vojtěch Bubník @bubnikv, Lukáš Matěna @lukasmatena, Oleksandra Iushchenko @YuSanka
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef slic3r_Utils_UndoRedoHistory_hpp_
+#define slic3r_Utils_UndoRedoHistory_hpp_
+
+// History of the objects tracked by the Undo / Redo stack, private to UndoRedo.cpp.
+// Exposed in a header to be unit tested.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace Slic3r {
+namespace UndoRedo {
+
+#ifdef SLIC3R_UNDOREDO_DEBUG
+static inline std::string ptr_to_string(const void* ptr)
+{
+    char buf[64];
+    sprintf(buf, "%p", ptr);
+    return buf;
+}
+#endif
+
+// Time interval, start is closed, end is open.
+struct Interval
+{
+public:
+	Interval(size_t begin, size_t end) : m_begin(begin), m_end(end) {}
+
+	size_t  begin() const { return m_begin; }
+	size_t  end()   const { return m_end; }
+
+	bool 	is_valid() const { return m_begin >= 0 && m_begin < m_end; }
+	// This interval comes strictly before the rhs interval.
+	bool 	strictly_before(const Interval &rhs) const { return this->is_valid() && rhs.is_valid() && m_end <= rhs.m_begin; }
+	// This interval comes strictly after the rhs interval.
+	bool 	strictly_after(const Interval &rhs) const { return this->is_valid() && rhs.is_valid() && rhs.m_end <= m_begin; }
+
+	bool    operator<(const Interval &rhs) const { return (m_begin < rhs.m_begin) || (m_begin == rhs.m_begin && m_end < rhs.m_end); }
+	bool 	operator==(const Interval &rhs) const { return m_begin == rhs.m_begin && m_end == rhs.m_end; }
+
+	void 	trim_begin(size_t new_begin)  { m_begin = std::max(m_begin, new_begin); }
+	void    trim_end(size_t new_end) { m_end = std::min(m_end, new_end); }
+	void 	extend_begin(size_t new_begin) { assert(new_begin <= m_begin); m_begin = new_begin; }
+	void 	extend_end(size_t new_end) { assert(new_end >= m_end); m_end = new_end; }
+
+	size_t 	memsize() const { return sizeof(this); }
+	// Memory released together with this interval.
+	size_t 	release() { return this->memsize(); }
+
+private:
+	size_t 	m_begin;
+	size_t 	m_end;
+};
+
+// History of a single object tracked by the Undo / Redo stack. The object may be mutable or immutable.
+class ObjectHistoryBase
+{
+public:
+	virtual ~ObjectHistoryBase() {}
+
+	// Is the object captured by this history mutable or immutable?
+	virtual bool is_mutable() const = 0;
+	virtual bool is_immutable() const = 0;
+	// The object is optional, it may be released if the Undo / Redo stack memory grows over the limits.
+	virtual bool is_optional() const { return false; }
+	// If it is an immutable object, return its pointer. There is a map assigning a temporary ObjectID to the immutable object pointer.
+	virtual const void* immutable_object_ptr() const { return nullptr; }
+
+	// If the history is empty, the ObjectHistory object could be released.
+	virtual bool empty() = 0;
+
+	// Release all data before the given timestamp. For the ImmutableObjectHistory, the shared pointer is NOT released.
+	// Return the amount of memory released.
+	virtual size_t release_before_timestamp(size_t timestamp) = 0;
+	// Release all data after the given timestamp. For the ImmutableObjectHistory, the shared pointer is NOT released.
+	// Return the amount of memory released.
+	virtual size_t release_after_timestamp(size_t timestamp) = 0;
+	// Release all data between the two timestamps. For the ImmutableObjectHistory, the shared pointer is NOT released.
+	// Used for reducing the number of snapshots for noisy operations like the support point edits.
+	// Return the amount of memory released.
+	virtual size_t release_between_timestamps(size_t timestamp_start, size_t timestamp_end) = 0;
+	// Release all optional data of this history.
+	virtual size_t release_optional() = 0;
+	// Restore optional data possibly released by release_optional.
+	virtual void   restore_optional() = 0;
+
+	// Estimated size in memory, to be used to drop least recently used snapshots.
+	virtual size_t memsize() const = 0;
+
+#ifdef SLIC3R_UNDOREDO_DEBUG
+	// Human readable debug information.
+	virtual std::string	format() = 0;
+#endif /* SLIC3R_UNDOREDO_DEBUG */
+
+#ifndef NDEBUG
+	virtual bool valid() = 0;
+#endif /* NDEBUG */
+};
+
+template<typename T> class ObjectHistory : public ObjectHistoryBase
+{
+public:
+	~ObjectHistory() override {}
+
+	// If the history is empty, the ObjectHistory object could be released.
+	bool empty() override { return m_history.empty(); }
+
+	// Release all data before the given timestamp. For the ImmutableObjectHistory, the shared pointer is NOT released.
+	size_t release_before_timestamp(size_t timestamp) override {
+		size_t mem_released = 0;
+		if (! m_history.empty()) {
+			assert(this->valid());
+			// it points to an interval which either starts with timestamp, or follows the timestamp.
+			auto it = std::lower_bound(m_history.begin(), m_history.end(), T(timestamp, timestamp));
+			// Find the first iterator with begin() < timestamp.
+			if (it == m_history.end())
+				-- it;
+			while (it != m_history.begin() && it->begin() >= timestamp)
+				-- it;
+			if (it->begin() < timestamp && it->end() > timestamp) {
+				it->trim_begin(timestamp);
+				if (it != m_history.begin())
+					-- it;
+			}
+			if (it->end() <= timestamp) {
+				auto it_end = ++ it;
+				for (it = m_history.begin(); it != it_end; ++ it)
+					mem_released += it->release();
+				m_history.erase(m_history.begin(), it_end);
+			}
+			assert(this->valid());
+		}
+		return mem_released;
+	}
+
+	// Release all data after the given timestamp. The shared pointer is NOT released.
+	size_t release_after_timestamp(size_t timestamp) override {
+		size_t mem_released = 0;
+		if (! m_history.empty()) {
+			assert(this->valid());
+			// it points to an interval which either starts with timestamp, or follows the timestamp.
+			auto it = std::lower_bound(m_history.begin(), m_history.end(), T(timestamp, timestamp));
+			if (it != m_history.begin()) {
+				auto it_prev = it;
+				-- it_prev;
+				assert(it_prev->begin() < timestamp);
+				// Trim the last interval with timestamp.
+				it_prev->trim_end(timestamp);
+			}
+			for (auto it2 = it; it2 != m_history.end(); ++ it2)
+				mem_released += it2->release();
+			m_history.erase(it, m_history.end());
+			assert(this->valid());
+		}
+		return mem_released;
+	}
+
+	// Release all data between the two timestamps. For the ImmutableObjectHistory, the shared pointer is NOT released.
+	// Used for reducing the number of snapshots for noisy operations like the support point edits.
+	// Return the amount of memory released.
+	size_t release_between_timestamps(size_t timestamp_start, size_t timestamp_end) override {
+		size_t mem_released = 0;
+		if (! m_history.empty()) {
+			assert(this->valid());
+			// Find the span of m_history intervals that are fully in (timestamp_start, timestamp_end>, thus they will be never
+			// deserialized for any snapshot in <timestamp_start, timestamp_end).
+			auto it_lo = std::upper_bound(m_history.begin(), m_history.end(), timestamp_start, [](size_t l, const auto &r) { return l < r.begin(); });
+			auto it_hi = std::upper_bound(it_lo, m_history.end(), timestamp_end, [](size_t l, const auto &r) { return l < r.end(); });
+			if (it_lo != it_hi) {
+				// There are some intervals that start inside (timestamp_start, timestamp_end), that could be released.
+				assert(it_lo->begin() > timestamp_start && it_lo->end() <= timestamp_end);
+				assert(it_hi == m_history.end() || (it_hi->begin() > it_lo->begin() && it_hi->end() > timestamp_end));
+				if (it_lo != m_history.begin() && it_hi != m_history.end()) {
+					// One may consider merging the two intervals.
+					//FIXME merge them.
+				}
+				for (auto it = it_lo; it != it_hi; ++ it)
+					mem_released += it->release();
+				m_history.erase(it_lo, it_hi);
+			}
+			assert(this->valid());
+		}
+		return mem_released;
+	}
+
+protected:
+	std::vector<T>	m_history;
+};
+
+struct MutableHistoryInterval
+{
+private:
+	// Serialized snapshot of a mutable object. Successive snapshots of an object mostly differ in a short span only
+	// (a painted region, a changed config value, a moved instance), therefore a snapshot is stored as a delta against
+	// the previous snapshot of the same object if it pays off: the bytes shared with the beginning and with the end
+	// of the base snapshot are referenced, only the middle span is stored. A full snapshot is stored every
+	// max_delta_chain snapshots to bound the cost of decoding.
+	struct Data
+	{
+		// Reference counter of this data chunk. We may have used shared_ptr, but the shared_ptr is thread safe
+		// with the associated cost of CPU cache invalidation on refcount change.
+		// Counts both the history intervals and the delta encoded data chunks referencing this data chunk.
+		size_t		refcnt;
+		// Size of the decoded data.
+		size_t		size;
+		// Data chunk this one is delta encoded against, nullptr if this chunk stores the complete data.
+		Data       *base;
+		// Number of bytes shared with the beginning and with the end of the base data.
+		size_t 		prefix;
+		size_t 		suffix;
+		// Length of the chain of delta encoded chunks ending with this one.
+		size_t 		depth;
+		// Number of bytes stored in data[].
+		size_t 		stored;
+		char 		data[1];
+
+		static Data* allocate(size_t size, Data *base, size_t prefix, size_t suffix, const char *src, size_t stored) {
+			Data *out = (Data*)new char[offsetof(Data, data) + stored];
+			out->refcnt = 1;
+			out->size   = size;
+			out->base   = base;
+			out->prefix = prefix;
+			out->suffix = suffix;
+			out->depth  = 0;
+			out->stored = stored;
+			if (base != nullptr) {
+				++ base->refcnt;
+				out->depth = base->depth + 1;
+			}
+			memcpy(out->data, src, stored);
+			return out;
+		}
+
+		// Release a reference to the data chunk, release the chain of its base chunks which are no more referenced.
+		// Returns the memory freed, only counting the chunks with reference counter dropping to zero.
+		static size_t release(Data *data) {
+			size_t released = 0;
+			while (data != nullptr && -- data->refcnt == 0) {
+				Data *base = data->base;
+				released += data->memsize();
+				delete[] (char*)data;
+				data = base;
+			}
+			return released;
+		}
+
+		// Memory occupied by this data chunk, not counting its base chunk.
+		size_t 		memsize() const { return offsetof(Data, data) + this->stored; }
+
+		// Call fn(ptr, len, out_offset) for the continuous spans of the decoded data <offset, offset + len).
+		// Stops and returns false as soon as fn() returns false.
+		template<typename Fn> bool visit(size_t offset, size_t len, Fn &fn, size_t out_offset = 0) const {
+			if (this->base == nullptr)
+				return len == 0 || fn(this->data + offset, len, out_offset);
+			const size_t end     = offset + len;
+			const size_t mid_end = this->size - this->suffix;
+			if (offset < end && offset < this->prefix) {
+				size_t e = std::min(end, this->prefix);
+				if (! this->base->visit(offset, e - offset, fn, out_offset))
+					return false;
+				out_offset += e - offset;
+				offset = e;
+			}
+			if (offset < end && offset < mid_end) {
+				size_t e = std::min(end, mid_end);
+				if (! fn(this->data + offset - this->prefix, e - offset, out_offset))
+					return false;
+				out_offset += e - offset;
+				offset = e;
+			}
+			return offset == end || this->base->visit(offset - mid_end + this->base->size - this->suffix, end - offset, fn, out_offset);
+		}
+
+		void 		decode(char *dst) const {
+			auto fn = [dst](const char *src, size_t len, size_t out_offset) { memcpy(dst + out_offset, src, len); return true; };
+			this->visit(0, this->size, fn);
+		}
+
+		bool 		equals(size_t offset, size_t len, const char *rhs) const {
+			auto fn = [rhs](const char *src, size_t len, size_t out_offset) { return memcmp(src, rhs + out_offset, len) == 0; };
+			return this->visit(offset, len, fn);
+		}
+
+		// The serialized data matches the data stored here.
+		bool 		matches(const std::string& rhs) const { return this->size == rhs.size() && this->equals(0, this->size, rhs.data()); }
+
+		// The timestamp matches the timestamp serialized in the data stored here.
+		bool 		matches_timestamp(uint64_t timestamp) const { assert(timestamp > 0);  assert(this->size > 8); return this->equals(0, 8, (const char*)&timestamp); }
+	};
+
+	// Maximum length of a chain of delta encoded data chunks.
+	static constexpr const size_t max_delta_chain = 16;
+
+	Interval    m_interval;
+	Data	   *m_data;
+
+public:
+	// Store input_data, possibly delta encoded against the data of the previous history interval of the same object.
+	MutableHistoryInterval(const Interval &interval, const std::string &input_data, const MutableHistoryInterval *prev = nullptr) : m_interval(interval), m_data(nullptr) {
+		if (prev != nullptr && prev->m_data->depth < max_delta_chain) {
+			Data 		*base = prev->m_data;
+			std::string  base_data(base->size, 0);
+			base->decode(base_data.data());
+			size_t 		 max_shared = std::min(base_data.size(), input_data.size());
+			size_t 		 prefix = 0;
+			while (prefix < max_shared && base_data[prefix] == input_data[prefix])
+				++ prefix;
+			size_t 		 suffix = 0;
+			while (suffix < max_shared - prefix && base_data[base_data.size() - suffix - 1] == input_data[input_data.size() - suffix - 1])
+				++ suffix;
+			size_t 		 stored = input_data.size() - prefix - suffix;
+			// Only delta encode if at least half of the data is shared with the base.
+			if (2 * stored < input_data.size())
+				m_data = Data::allocate(input_data.size(), base, prefix, suffix, input_data.data() + prefix, stored);
+		}
+		if (m_data == nullptr)
+			m_data = Data::allocate(input_data.size(), nullptr, 0, 0, input_data.data(), input_data.size());
+	}
+
+	MutableHistoryInterval(const Interval &interval, MutableHistoryInterval &other) : m_interval(interval), m_data(other.m_data) {
+		++ m_data->refcnt;
+	}
+
+	// as a key for std::lower_bound
+	MutableHistoryInterval(const size_t begin, const size_t end) : m_interval(begin, end), m_data(nullptr) {}
+
+	MutableHistoryInterval(MutableHistoryInterval&& rhs) : m_interval(rhs.m_interval), m_data(rhs.m_data) { rhs.m_data = nullptr; }
+	MutableHistoryInterval& operator=(MutableHistoryInterval&& rhs) { m_interval = rhs.m_interval; std::swap(m_data, rhs.m_data); return *this; }
+
+	~MutableHistoryInterval() { Data::release(m_data); }
+
+	const Interval& interval() const { return m_interval; }
+	size_t		begin() const { return m_interval.begin(); }
+	size_t		end()   const { return m_interval.end(); }
+	void 		trim_begin  (size_t timestamp) { m_interval.trim_begin(timestamp); }
+	void 		trim_end    (size_t timestamp) { m_interval.trim_end(timestamp); }
+	void 		extend_begin(size_t timestamp) { m_interval.extend_begin(timestamp); }
+	void 		extend_end  (size_t timestamp) { m_interval.extend_end(timestamp); }
+
+	bool		operator<(const MutableHistoryInterval& rhs) const { return m_interval < rhs.m_interval; }
+	bool 		operator==(const MutableHistoryInterval& rhs) const { return m_interval == rhs.m_interval; }
+
+	// Identifies the data chunk, which may be shared by multiple history intervals.
+	const char* data() const { return m_data->data; }
+	// Size of the decoded data.
+	size_t  	size() const { return m_data->size; }
+	size_t		refcnt() const { return m_data->refcnt; }
+	std::string decode() const { std::string out(m_data->size, 0); m_data->decode(out.data()); return out; }
+	bool		matches(const std::string& data) const { return m_data->matches(data); }
+	bool		matches_timestamp(uint64_t timestamp) const { return m_data->matches_timestamp(timestamp); }
+	// Memory of the data chunk referenced by this interval, not counting its base chunks.
+	size_t 		data_memsize() const { return m_data->memsize(); }
+	// Memory of the data chunks reachable from this interval, which were not visited yet. Each data chunk is counted once,
+	// including the base chunks, which may be kept alive by the delta encoded chunks only.
+	size_t 		memsize(std::set<const void*> &visited) const {
+		size_t memsize = 0;
+		// Base chunks of a visited chunk have been visited already.
+		for (const Data *data = m_data; data != nullptr && visited.insert(data).second; data = data->base)
+			memsize += data->memsize();
+		return memsize;
+	}
+	// Release this interval together with its reference to the data chunk.
+	// Returns the memory actually freed, the data chunk may still be referenced by other intervals or delta encoded chunks.
+	size_t 		release() { size_t released = sizeof(*this) + Data::release(m_data); m_data = nullptr; return released; }
+
+#ifndef NDEBUG
+	// Count references of the data chunks held by the delta encoded data chunks, which are reachable from this interval.
+	void 		count_base_references(std::map<const char*, size_t> &refcntrs, std::set<const void*> &visited) const {
+		for (const Data *data = m_data; data->base != nullptr && visited.insert(data).second; data = data->base) {
+			assert(data->depth == data->base->depth + 1);
+			assert(data->prefix + data->suffix + data->stored == data->size);
+			++ refcntrs[data->base->data];
+		}
+	}
+#endif /* NDEBUG */
+
+private:
+	MutableHistoryInterval(const MutableHistoryInterval &rhs);
+	MutableHistoryInterval& operator=(const MutableHistoryInterval &rhs);
+};
+
+// Smaller objects (Model, ModelObject, ModelInstance, ModelVolume, DynamicPrintConfig)
+// are mutable and there is not tracking of the changes, therefore a snapshot needs to be
+// taken every time and compared to the previous data at the Undo / Redo stack.
+// The serialized data is stored if it is different from the last value on the stack, otherwise
+// the serialized data is discarded.
+// The history of a single mutable object may not be continuous, as an mutable object may
+// be removed from the scene while being kept at the Copy / Paste stack, therefore an object snapshot
+// with the same serialized object data may be shared by multiple history intervals.
+template<typename T>
+class MutableObjectHistory : public ObjectHistory<MutableHistoryInterval>
+{
+public:
+	~MutableObjectHistory() override {}
+
+	bool is_mutable() const override { return true; }
+	bool is_immutable() const override { return false; }
+
+	// Estimated size in memory, to be used to drop least recently used snapshots.
+	size_t memsize() const override { return sizeof(*this) + m_memsize; }
+
+	size_t release_before_timestamp(size_t timestamp) override
+		{ return this->account_released(ObjectHistory<MutableHistoryInterval>::release_before_timestamp(timestamp)); }
+	size_t release_after_timestamp(size_t timestamp) override
+		{ return this->account_released(ObjectHistory<MutableHistoryInterval>::release_after_timestamp(timestamp)); }
+	size_t release_between_timestamps(size_t timestamp_start, size_t timestamp_end) override
+		{ return this->account_released(ObjectHistory<MutableHistoryInterval>::release_between_timestamps(timestamp_start, timestamp_end)); }
+
+	// If an object provides a reliable timestamp and the object serializes the timestamp first,
+	// then we may just check the validity of the timestamp against the last snapshot without 
+	// having to serialize the whole object. This reduces the amount of serialization and memcmp 
+	// when taking a snapshot.
+	bool try_save_timestamp(size_t active_snapshot_time, size_t current_time, uint64_t timestamp) {
+		assert(m_history.empty() || m_history.back().end() <= active_snapshot_time);
+		if (! m_history.empty() && m_history.back().matches_timestamp(timestamp)) {
+			if (m_history.back().end() < active_snapshot_time)
+				// Share the previous data by reference counting.
+				this->share_last(current_time);
+			else {
+				assert(m_history.back().end() == active_snapshot_time);
+				// Just extend the last interval using the old data.
+				m_history.back().extend_end(current_time + 1);
+			}
+			return true;
+		}
+		// The timestamp is not valid, the caller has to call this->save() with the serialized data.
+		return false;
+	}
+
+	void save(size_t active_snapshot_time, size_t current_time, const std::string &data) {
+		assert(m_history.empty() || m_history.back().end() <= active_snapshot_time);
+		if (m_history.empty() || m_history.back().end() < active_snapshot_time) {
+			if (! m_history.empty() && m_history.back().matches(data))
+				// Share the previous data by reference counting.
+				this->share_last(current_time);
+			else
+				// Allocate new data, delta encoded against the previous data if possible.
+				this->store(Interval(current_time, current_time + 1), data);
+		} else {
+			assert(! m_history.empty());
+			assert(m_history.back().end() == active_snapshot_time);
+			if (m_history.back().matches(data))
+				// Just extend the last interval using the old data.
+				m_history.back().extend_end(current_time + 1);
+			else
+				// Allocate new data time continuous with the previous data, delta encoded against the previous data if possible.
+				this->store(Interval(active_snapshot_time, current_time + 1), data);
+		}
+	}
+
+	std::string load(size_t timestamp) const {
+		assert(! m_history.empty());
+		auto it = std::lower_bound(m_history.begin(), m_history.end(), MutableHistoryInterval(timestamp, timestamp));
+		if (it == m_history.end() || it->begin() > timestamp) {
+			assert(it != m_history.begin());
+			-- it;
+		}
+		assert(timestamp >= it->begin() && timestamp < it->end());
+		return it->decode();
+	}
+
+	// Currently all mutable snapshots are mandatory.
+	size_t release_optional() override { return 0; }
+	// Currently there is no way to release optional data from the mutable objects.
+	void   restore_optional() override {}
+
+#ifdef SLIC3R_UNDOREDO_DEBUG
+	std::string format() override {
+		std::string out = typeid(T).name();
+		for (const MutableHistoryInterval &interval : m_history)
+			out += std::string(", ptr:") + ptr_to_string(interval.data()) + " len:" + std::to_string(interval.size()) + " <" + std::to_string(interval.begin()) + "," + std::to_string(interval.end()) + ")";
+		return out;
+	}
+#endif /* SLIC3R_UNDOREDO_DEBUG */
+
+#ifndef NDEBUG
+	bool valid() override;
+#endif /* NDEBUG */
+
+private:
+	void share_last(size_t current_time) {
+		m_history.emplace_back(Interval(current_time, current_time + 1), m_history.back());
+		m_memsize += sizeof(MutableHistoryInterval);
+		assert(m_memsize == this->memsize_reachable());
+	}
+
+	void store(const Interval &interval, const std::string &data) {
+		m_history.emplace_back(interval, data, m_history.empty() ? nullptr : &m_history.back());
+		m_memsize += sizeof(MutableHistoryInterval) + m_history.back().data_memsize();
+		assert(m_memsize == this->memsize_reachable());
+	}
+
+	size_t account_released(size_t mem_released) {
+		assert(mem_released <= m_memsize);
+		m_memsize -= mem_released;
+		assert(m_memsize == this->memsize_reachable());
+		return mem_released;
+	}
+
+#ifndef NDEBUG
+	// Memory of the history intervals and of the data chunks reachable from them, to verify m_memsize.
+	size_t memsize_reachable() const {
+		size_t memsize = m_history.size() * sizeof(MutableHistoryInterval);
+		std::set<const void*> visited;
+		for (const MutableHistoryInterval &interval : m_history)
+			memsize += interval.memsize(visited);
+		return memsize;
+	}
+#endif /* NDEBUG */
+
+	// Memory of the history intervals and of the data chunks they keep alive, updated on store and on release
+	// to not walk the chains of delta encoded data chunks every time the Undo / Redo stack checks its memory limit.
+	size_t m_memsize { 0 };
+};
+
+#ifndef NDEBUG
+template<typename T>
+bool MutableObjectHistory<T>::valid()
+{
+	// Verify that the history intervals are sorted and do not overlap, and that the data reference counters are correct.
+	if (! m_history.empty()) {
+		std::map<const char*, size_t> refcntrs;
+		assert(m_history.front().data() != nullptr);
+		++ refcntrs[m_history.front().data()];
+		for (size_t i = 1; i < m_history.size(); ++ i) {
+			assert(m_history[i - 1].interval().strictly_before(m_history[i].interval()));
+			++ refcntrs[m_history[i].data()];
+		}
+		std::set<const void*> visited;
+		for (const auto &hi : m_history)
+			hi.count_base_references(refcntrs, visited);
+		for (const auto &hi : m_history) {
+			assert(hi.data() != nullptr);
+			assert(refcntrs[hi.data()] == hi.refcnt());
+		}
+	}
+	return true;
+}
+#endif /* NDEBUG */
+
+} // namespace UndoRedo
+} // namespace Slic3r
+
+#endif /* slic3r_Utils_UndoRedoHistory_hpp_ */
@@ -464,6 +464,65 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("Cached NFPs should match the calculated ones", "[arrange2]") {
+    using namespace Slic3r;
+
+    auto parts = prusa_parts_ex();
+    REQUIRE(parts.size() > 3);
+
+    arr2::NFPCache cache;
+
+    // Same shapes at different positions have to reuse the cached NFP
+    for (const Vec2crd &pos : {Vec2crd{0, 0}, Vec2crd{scaled(-53.), scaled(17.)}}) {
+        for (double rot : {0., PI / 4.}) {
+            ArrangeItem fixed = parts[2];
+            fixed.translation(pos);
+            fixed.rotation(rot);
+
+            ArrangeItem orbiter = parts[3];
+            orbiter.translation(-pos);
+            orbiter.rotation(-rot);
+
+            std::array<std::reference_wrapper<const ArrangeItem>, 1> fixed_items = {{fixed}};
+
+            Polygons nfp = arr2::calculate_nfp_unnormalized(orbiter, crange(fixed_items));
+            Polygons nfp_cached = arr2::calculate_nfp_unnormalized(orbiter, crange(fixed_items),
+                                                                   arr2::DefaultStopCondition{},
+                                                                   &cache);
+
+            REQUIRE(!nfp.empty());
+            REQUIRE(diff(nfp, nfp_cached).empty());
+            REQUIRE(diff(nfp_cached, nfp).empty());
+        }
+    }
+
+    // One entry for each pair of convex parts and each pair of rotations
+    size_t pairs = parts[2].shape().contours().size() * parts[3].envelope().contours().size();
+    REQUIRE(cache.size() == 2 * pairs);
+}
+
+TEST_CASE("Cached NFP is not returned for different contours with the same key", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::NFPCache cache;
+
+    // Simulate a collision of the contour hashes
+    arr2::NFPCache::Key key{1, 0., 0, 2, 0., 0};
+    Polygon square{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    Polygon triangle{{0, 0}, {10, 0}, {0, 10}};
+    Polygon nfp{{-10, -10}, {10, -10}, {10, 10}, {-10, 10}};
+    cache.insert(key, square, triangle, nfp, Vec2crd{10, 10});
+
+    Polygon found_nfp;
+    Vec2crd found_refv;
+    REQUIRE(cache.find(key, square, triangle, found_nfp, found_refv));
+    REQUIRE(found_nfp == nfp);
+    REQUIRE(found_refv == Vec2crd{10, 10});
+
+    REQUIRE(!cache.find(key, triangle, triangle, found_nfp, found_refv));
+    REQUIRE(!cache.find(key, square, square, found_nfp, found_refv));
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
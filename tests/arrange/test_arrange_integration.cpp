@@ -18,6 +18,10 @@
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "libslic3r/Format/3mf.hpp"
 
+#include "../data/prusaparts.hpp"
+
+#include <tbb/task_arena.h>
+
 using namespace Catch;
 
 static Slic3r::Model get_example_model_with_20mm_cube()
@@ -803,6 +807,75 @@ TEST_CASE("Testing a simple arrange on cubes", "[arrange2][integration]")
     REQUIRE(is_collision_free(range(task->printable.selected)));
 }
 
+TEST_CASE("Arranging with several starts in parallel", "[arrange2][integration]")
+{
+    using namespace Slic3r;
+
+    struct Ctl : public arr2::ArrangerCtl<arr2::ArrangeItem> {
+        std::vector<const arr2::ArrangeItem *> packed;
+
+        void update_status(int) override {}
+        bool was_canceled() const override { return false; }
+        void on_packed(arr2::ArrangeItem &itm) override { packed.emplace_back(&itm); }
+    };
+
+    // Beds used and the total area of the piles on them.
+    auto score = [](const std::vector<arr2::ArrangeItem> &items) {
+        std::map<int, BoundingBox> piles;
+        for (const arr2::ArrangeItem &itm : items)
+            piles[arr2::get_bed_index(itm)].merge(arr2::fixed_bounding_box(itm));
+
+        double pile_area = 0.;
+        for (auto &[bedidx, pilebb] : piles)
+            pile_area += unscaled(pilebb).size().x() * unscaled(pilebb).size().y();
+
+        return std::make_pair(piles.size(), pile_area);
+    };
+
+    std::vector<arr2::ArrangeItem> input;
+    for (size_t i = 0; i < 30; ++i)
+        input.emplace_back(Geometry::convex_hull(PRUSA_PART_POLYGONS[i % 12]));
+
+    arr2::ArrangeSettings settings;
+    settings.set_rotation_enabled(true);
+
+    auto bed = arr2::RectangleBed{scaled(250.), scaled(210.)};
+    auto arranger = arr2::Arranger<arr2::ArrangeItem>::create(settings);
+
+    // A single thread allows a single start only.
+    std::vector<arr2::ArrangeItem> single = input;
+    tbb::task_arena(1).execute([&] { arranger->arrange(single, {}, bed, Ctl{}); });
+
+    std::vector<arr2::ArrangeItem> items = input;
+    Ctl ctl;
+    tbb::task_arena(4).execute([&] { arranger->arrange(items, {}, bed, ctl); });
+
+    REQUIRE(std::all_of(items.begin(), items.end(),
+                        [](auto &item) { return arr2::is_arranged(item); }));
+
+    std::map<int, std::vector<arr2::ArrangeItem>> beds;
+    for (const arr2::ArrangeItem &itm : items)
+        beds[arr2::get_bed_index(itm)].emplace_back(itm);
+
+    for (auto &[bedidx, bed_items] : beds)
+        REQUIRE((bed_items.size() < 2 || is_collision_free(range(bed_items))));
+
+    // Each item is reported once, after the arrangement of the best start
+    // was applied.
+    REQUIRE(ctl.packed.size() == items.size());
+    REQUIRE(std::set<const arr2::ArrangeItem *>(ctl.packed.begin(), ctl.packed.end()).size() == items.size());
+
+    // The first start uses the same order as the single start, it wins
+    // the ties.
+    REQUIRE(score(items) <= score(single));
+
+    // The cached no-fit polygons are released with the arrangement.
+    REQUIRE(std::all_of(items.begin(), items.end(), [](auto &item) {
+        auto cache = arr2::get_data<std::shared_ptr<arr2::NFPCache>>(item, "nfp_cache");
+        return cache == nullptr || *cache == nullptr;
+    }));
+}
+
 TEST_CASE("Testing arrangement involving virtual beds", "[arrange2][integration]")
 {
     using namespace Slic3r;
@@ -166,6 +166,29 @@ SCENARIO("Cooling unit tests", "[Cooling]") {
             REQUIRE(fan_activated);      
         }
     }
+
+    WHEN("G-code block 5") {
+        const std::string gcode_src =
+            "G1 X50 F2500 ; travel\n"
+            "G1 F3000 ;_EXTRUDE_SET_SPEED;_EXTERNAL_PERIMETER ; perimeter\n"
+            "G1 X100 E1\n"
+            ";_EXTRUDE_END\n"
+            "G1 F2400 ;_WIPE\n"
+            "G1 X90 E-0.5 ; wipe and retract\n";
+        config.set_deserialize_strict({ { "slowdown_below_layer_time", 0 } });
+        GCodeGenerator gcodegen;
+        auto buffer = make_cooling_buffer(gcodegen, config);
+        std::string gcode = buffer->process_layer(gcode_src, 0, true);
+        THEN("cooling markers are removed") {
+            REQUIRE(gcode.find(";_") == gcode.npos);
+        }
+        THEN("feedrates and comments are kept") {
+            REQUIRE(gcode.find("G1 X50 F2500 ; travel\n") != gcode.npos);
+            REQUIRE(gcode.find("G1 F3000  ; perimeter\n") != gcode.npos);
+            REQUIRE(gcode.find("G1 F2400") != gcode.npos);
+            REQUIRE(gcode.find("G1 X90 E-0.5 ; wipe and retract\n") != gcode.npos);
+        }
+    }
 }
 
 SCENARIO("Cooling integration tests", "[Cooling]") {
@@ -4,6 +4,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include <memory>
 #include <regex>
@@ -316,6 +317,37 @@ TEST_CASE("M73s have correct percent values", "[GCode]") {
 }
 
 
+TEST_CASE("Footer placeholders are filled in", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+    // Without remaining times only the footer is rewritten by the post-processor.
+    const bool remaining_times = GENERATE(false, true);
+    // A placeholder in the start G-code tells whether the header was rewritten.
+    const std::string placeholder = ";" + GCodeProcessor::reserved_tag(GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder) + "\n";
+    config.set_deserialize_strict({
+        { "remaining_times", remaining_times },
+        { "start_gcode", placeholder },
+    });
+
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+    const std::string gcode = Test::gcode(print);
+
+    const size_t footer_start = gcode.rfind("; estimated printing time (normal mode) = ");
+    REQUIRE(footer_start != std::string::npos);
+    const size_t header_placeholder = gcode.find(placeholder);
+    if (remaining_times) {
+        // The whole file was post-processed.
+        CHECK(header_placeholder == std::string::npos);
+    } else {
+        // Only the footer was post-processed, the header bytes were not rewritten.
+        CHECK(header_placeholder < footer_start);
+        CHECK(gcode.find(placeholder, header_placeholder + 1) == std::string::npos);
+    }
+    CHECK(gcode.find(PrintStatistics::FilamentUsedMmMask + " ") != std::string::npos);
+    CHECK(gcode.find("; prusaslicer_config = end\n") != std::string::npos);
+}
+
 TEST_CASE("M201 for acceleation reset", "[GCode]") {
     DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
     config.set_deserialize_strict({
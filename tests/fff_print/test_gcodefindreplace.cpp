@@ -290,3 +290,51 @@ SCENARIO("Find/Replace with regexp", "[GCodeFindReplace]") {
         }
     }
 }
+
+SCENARIO("Find/Replace with multiple substitutions", "[GCodeFindReplace]") {
+    GIVEN("G-code") {
+        const std::string gcode =
+            "G1 Z0; home\n"
+            "G1 Z1; move up\n"
+            "G1 X0 Y1 Z1; perimeter\n"
+            "G1 X13 Y32 Z1; infill\n"
+            "G1 X13 Y32 Z1; wipe\n";
+        WHEN("Independent plain text substitutions") {
+            GCodeFindReplace find_replace({
+                "home",      "homing",      "", "",
+                "perimeter", "wall",        "", "",
+                "infill",    "fill",        "", "",
+                "G1 Z1;",    "G0 Z1;",      "", "" });
+            REQUIRE(find_replace.process_layer(gcode) ==
+                "G1 Z0; homing\n"
+                "G0 Z1; move up\n"
+                "G1 X0 Y1 Z1; wall\n"
+                "G1 X13 Y32 Z1; fill\n"
+                "G1 X13 Y32 Z1; wipe\n");
+        }
+        WHEN("Substitution applied to the result of the previous substitution") {
+            GCodeFindReplace find_replace({
+                "move up",   "move down",   "", "",
+                "down",      "back",        "", "",
+                "wipe",      "",            "", "",
+                "1; ",       "1 ; ",        "", "" });
+            REQUIRE(find_replace.process_layer(gcode) ==
+                "G1 Z0; home\n"
+                "G1 Z1 ; move back\n"
+                "G1 X0 Y1 Z1 ; perimeter\n"
+                "G1 X13 Y32 Z1 ; infill\n"
+                "G1 X13 Y32 Z1 ; \n");
+        }
+        WHEN("Overlapping patterns") {
+            GCodeFindReplace find_replace({
+                "Z1; inf",   "Z2; inf",     "", "",
+                "X13 Y32 Z", "X14 Y32 Z",   "", "" });
+            REQUIRE(find_replace.process_layer(gcode) ==
+                "G1 Z0; home\n"
+                "G1 Z1; move up\n"
+                "G1 X0 Y1 Z1; perimeter\n"
+                "G1 X14 Y32 Z2; infill\n"
+                "G1 X14 Y32 Z1; wipe\n");
+        }
+    }
+}
@@ -127,6 +127,77 @@ SCENARIO("Print: Brim generation", "[Print]") {
     }
 }
 
+SCENARIO("Print: Layers over the memory budget are written out", "[Print]") {
+    GIVEN("20mm cube with avoid crossing perimeters") {
+        auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+            { "avoid_crossing_perimeters",  1 },
+            { "brim_width",                 3 }
+        });
+        // Skip the line with a time stamp.
+        auto gcode_body = [](Print &print) { std::string out = Slic3r::Test::gcode(print); return out.substr(out.find('\n')); };
+
+        Slic3r::Print print_ref;
+        Slic3r::Model model_ref;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print_ref, model_ref, config);
+        const std::string gcode_ref = gcode_body(print_ref);
+
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        print.set_memory_budget(1);
+        print.set_status_silent();
+        print.process();
+        const PrintObject &object = *print.objects().front();
+        THEN("All the layers are written out") {
+            for (const Layer *layer : object.layers())
+                REQUIRE(layer->spilled());
+        }
+        THEN("Layers do not hold the slices") {
+            REQUIRE(object.layers()[10]->regions().front()->slices().empty());
+        }
+        THEN("G-code is the same as without the memory budget") {
+            REQUIRE(gcode_body(print) == gcode_ref);
+            REQUIRE(print.layer_spill()->bytes_reloaded() > 0);
+        }
+        WHEN("The print is invalidated and processed again") {
+            config.set_deserialize_strict({ { "fill_density", "40%" } });
+            print.apply(model, config);
+            print_ref.apply(model_ref, config);
+            THEN("G-code is the same as without the memory budget") {
+                REQUIRE(gcode_body(print) == gcode_body(print_ref));
+            }
+        }
+    }
+    GIVEN("Two 20mm cubes printed one by one with avoid crossing perimeters") {
+        auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+            { "avoid_crossing_perimeters",  1 },
+            { "complete_objects",           1 }
+        });
+        auto gcode_body = [](Print &print) { std::string out = Slic3r::Test::gcode(print); return out.substr(out.find('\n')); };
+
+        Slic3r::Print print_ref;
+        Slic3r::Model model_ref;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20, TestMesh::cube_20x20x20}, print_ref, model_ref, config);
+        const std::string gcode_ref = gcode_body(print_ref);
+
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20, TestMesh::cube_20x20x20}, print, model, config);
+        print.set_memory_budget(1);
+        print.set_status_silent();
+        print.process();
+        THEN("G-code is the same as without the memory budget") {
+            REQUIRE(gcode_body(print) == gcode_ref);
+        }
+        THEN("Layers of all objects are written out again after the export") {
+            gcode_body(print);
+            for (const PrintObject *object : print.objects())
+                for (const Layer *layer : object->layers())
+                    REQUIRE(layer->regions().front()->slices().empty());
+        }
+    }
+}
+
 SCENARIO("Ported from Perl", "[Print]") {
     GIVEN("20mm cube") {
         WHEN("Print center is set to 100x100 (test framework default)")  {
@@ -164,3 +164,19 @@ TEST_CASE_METHOD(Test::SeamsFixture, "Calculate visibility", "[Seams][SeamAligne
         }
     }
 }
+
+TEST_CASE_METHOD(Test::SeamsFixture, "Visibility cache", "[Seams][SeamAligned][Integration]") {
+    Slic3r::ModelInfo::VisibilityCache cache;
+
+    const std::shared_ptr<const Slic3r::ModelInfo::Visibility> first{
+        cache.get(transformation, volumes, params.visibility, []() {})};
+    const std::shared_ptr<const Slic3r::ModelInfo::Visibility> second{
+        cache.get(transformation, volumes, params.visibility, []() {})};
+    CHECK(first == second);
+    CHECK(first->mesh_samples_visibility == visibility.mesh_samples_visibility);
+
+    const Transform3d moved{Slic3r::Geometry::translation_transform(Vec3d{1.0, 0.0, 0.0}) * transformation};
+    const std::shared_ptr<const Slic3r::ModelInfo::Visibility> third{
+        cache.get(moved, volumes, params.visibility, []() {})};
+    CHECK(third != first);
+}
@@ -197,6 +197,21 @@ TEST_CASE_METHOD(Test::SeamsFixture, "Create perimeters", "[Seams][SeamPerimeter
     }
 }
 
+TEST_CASE_METHOD(Test::SeamsFixture, "Painting cache", "[Seams][SeamPerimeters][Integration]") {
+    Seams::ModelInfo::PaintingCache cache;
+
+    const std::shared_ptr<const Seams::ModelInfo::Painting> first{cache.get(transformation, volumes)};
+    const std::shared_ptr<const Seams::ModelInfo::Painting> second{cache.get(transformation, volumes)};
+    CHECK(first == second);
+
+    const Transform3d moved{Slic3r::Geometry::translation_transform(Vec3d{1.0, 0.0, 0.0}) * transformation};
+    const std::shared_ptr<const Seams::ModelInfo::Painting> third{cache.get(moved, volumes)};
+    CHECK(third != first);
+
+    cache.clear();
+    CHECK(cache.get(moved, volumes) != third);
+}
+
 using Dir = Seams::Geometry::Direction1D;
 
 Perimeters::Perimeter get_perimeter(){
@@ -6,6 +6,7 @@
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/AABBTreeLines.hpp>
+#include <libslic3r/AABBTreeWide.hpp>
 
 using namespace Slic3r;
 using namespace Catch;
@@ -63,6 +64,55 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Wide tree ray casting matches the binary tree", "[AABBIndirect]")
+{
+    indexed_triangle_set its = its_make_sphere(10., 2. * PI / 60.);
+    its_merge(its, its_make_cube(5., 5., 30.));
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    AABBTreeIndirect::WideTree4 wide_tree;
+    wide_tree.build(tree);
+    REQUIRE(! wide_tree.empty());
+
+    // Rays from the inside towards a fan of directions, and rays from the outside towards the box.
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    for (int i = 0; i < 37; ++ i) {
+        const double alpha = 2. * PI * i / 37.;
+        const double beta  = PI * (i % 7 - 3) / 8.;
+        const Vec3d  dir   = Vec3d(std::cos(alpha) * std::cos(beta), std::sin(alpha) * std::cos(beta), std::sin(beta));
+        origins.emplace_back(0.1, 0.2, 0.3);
+        dirs.emplace_back(dir);
+        origins.emplace_back(40. * dir + Vec3d(0.3, 0.7, 0.5 * i + 0.1));
+        dirs.emplace_back(- dir);
+    }
+    // Axis aligned rays, the second one missing the objects.
+    origins.emplace_back(1., 2., -50.);
+    dirs.emplace_back(0., 0., 1.);
+    origins.emplace_back(100., 100., 100.);
+    dirs.emplace_back(1., 0., 0.);
+
+    std::vector<igl::Hit> hits;
+    size_t num_hits = AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices, wide_tree, origins, dirs, hits);
+    REQUIRE(hits.size() == origins.size());
+    size_t num_expected_hits = 0;
+    for (size_t i = 0; i < origins.size(); ++ i) {
+        igl::Hit expected;
+        bool hit = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], expected);
+        igl::Hit single;
+        REQUIRE(AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, wide_tree, origins[i], dirs[i], single) == hit);
+        REQUIRE((hits[i].id >= 0) == hit);
+        if (hit) {
+            ++ num_expected_hits;
+            CHECK(hits[i].t == Approx(expected.t));
+            CHECK(single.t == Approx(expected.t));
+        }
+    }
+    CHECK(num_hits == num_expected_hits);
+    CHECK(num_hits > 0);
+    CHECK(num_hits < origins.size());
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
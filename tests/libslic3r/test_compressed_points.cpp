@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <limits>
+
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/CompressedPoints.hpp"
+#include "libslic3r/ExPolygon.hpp"
+
+using namespace Slic3r;
+
+// A circle of 5mm radius sampled with 0.1mm resolution, with a square hole.
+static ExPolygon ring_with_hole(const Point &center)
+{
+    ExPolygon out;
+    for (size_t i = 0; i < 314; ++ i) {
+        const double a = 2. * PI * double(i) / 314.;
+        out.contour.points.emplace_back(center + Point(scaled<double>(5. * cos(a)), scaled<double>(5. * sin(a))));
+    }
+    out.holes.push_back(Polygon{ center + Point(scaled(1.), -scaled(1.)), center - Point(scaled(1.), scaled(1.)), center + Point(-scaled(1.), scaled(1.)), center + Point(scaled(1.), scaled(1.)) });
+    return out;
+}
+
+SCENARIO("Compressed points", "[CompressedPoints]") {
+    GIVEN("Points with extreme coordinates") {
+        const coord_t min = std::numeric_limits<coord_t>::min();
+        const coord_t max = std::numeric_limits<coord_t>::max();
+        const Points  points{ { 0, 0 }, { max, min }, { min, max }, { -1, 1 }, { 1, -1 }, { max, max }, { min, min } };
+        WHEN("compressed") {
+            CompressedPaths paths;
+            paths.append(points);
+            paths.append(Points());
+            THEN("decompressed points match") {
+                REQUIRE(paths.size() == 2);
+                REQUIRE(paths.points(0) == points);
+                REQUIRE(paths.points(1).empty());
+            }
+        }
+    }
+    GIVEN("Two rings with holes") {
+        const ExPolygons expolygons{ ring_with_hole(Point(scaled(10.), scaled(10.))), ring_with_hole(Point(scaled(16.), scaled(10.))) };
+        const CompressedExPolygons compressed(expolygons);
+        THEN("ExPolygons are decompressed one by one or all at once") {
+            REQUIRE(compressed.size() == 2);
+            REQUIRE(compressed.expolygon(1) == expolygons[1]);
+            REQUIRE(compressed.expolygons() == expolygons);
+        }
+        THEN("Paths iterated over match contours and holes") {
+            Polygons polygons;
+            for (const Points &points : compressed.paths())
+                polygons.emplace_back(points);
+            REQUIRE(polygons == to_polygons(expolygons));
+        }
+        THEN("Compressed data takes less than two thirds of the memory") {
+            REQUIRE(compressed.memory_size() * 3 < count_points(expolygons) * sizeof(Point) * 2);
+        }
+        THEN("Clipping operations over compressed ExPolygons match the uncompressed ones") {
+            const ExPolygons square{ ExPolygon(Polygon::new_scale({ { 12., 5. }, { 20., 5. }, { 20., 15. }, { 12., 15. } })) };
+            REQUIRE(union_ex(compressed) == union_ex(expolygons));
+            REQUIRE(diff_ex(square, compressed) == diff_ex(square, expolygons));
+            REQUIRE(intersection_ex(square, compressed) == intersection_ex(square, expolygons));
+        }
+    }
+}
@@ -160,6 +160,51 @@ TEST_CASE("No interference between DynamicConfig objects", "[Config]") {
     CHECK(config.opt_string("fill_pattern") == "line");
 }
 
+TEST_CASE("Copies of DynamicConfig share options until modified", "[Config]") {
+    DynamicPrintConfig config;
+    config.set_key_value("perimeters", new ConfigOptionInt(2));
+    config.set_key_value("extruder_offset", new ConfigOptionPoints({{0, 0}, {20, 0}}));
+
+    DynamicPrintConfig copy = config;
+    // Only a non-const access detaches a shared option.
+    CHECK(std::as_const(copy).option("extruder_offset") == std::as_const(config).option("extruder_offset"));
+    CHECK(copy.diff(config).empty());
+
+    copy.opt_int("perimeters") = 3;
+    copy.option<ConfigOptionPoints>("extruder_offset")->values.emplace_back(0, 20);
+    CHECK(config.opt_int("perimeters") == 2);
+    CHECK(config.option<ConfigOptionPoints>("extruder_offset")->values.size() == 2);
+    CHECK(copy.diff(config) == t_config_option_keys{ "extruder_offset", "perimeters" });
+
+    DynamicPrintConfig applied;
+    applied.set_key_value("perimeters", new ConfigOptionInt(5));
+    applied.apply(copy);
+    CHECK(std::as_const(applied).option("perimeters") == std::as_const(copy).option("perimeters"));
+    CHECK(applied.diff(copy).empty());
+    applied.opt_int("perimeters") = 4;
+    CHECK(copy.opt_int("perimeters") == 3);
+}
+
+TEST_CASE("Adding DynamicConfigs keeps the class of the options", "[Config]") {
+    DynamicConfig config;
+    config.set_key_value("temperature", new ConfigOptionFloatsNullable({ ConfigOptionFloatsNullable::nil_value() }));
+    config.set_key_value("perimeters", new ConfigOptionInt(2));
+    DynamicConfig other;
+    other.set_key_value("temperature", new ConfigOptionFloats({ 210. }));
+    other.set_key_value("perimeters", new ConfigOptionInt(3));
+    const DynamicConfig other_copy = other;
+
+    config += other;
+    // The nullable option stays nullable, it receives the value only.
+    REQUIRE(dynamic_cast<const ConfigOptionFloatsNullable*>(std::as_const(config).option("temperature")) != nullptr);
+    CHECK(std::as_const(config).option<ConfigOptionFloatsNullable>("temperature")->values == std::vector<double>{ 210. });
+    // An option of the same class is shared.
+    CHECK(std::as_const(config).option("perimeters") == std::as_const(other).option("perimeters"));
+    config.opt_int("perimeters") = 4;
+    config.option<ConfigOptionFloatsNullable>("temperature")->values.front() = 200.;
+    CHECK(other == other_copy);
+}
+
 TEST_CASE("Normalize fdm extruder", "[Config]") {
     DynamicPrintConfig config;
     config.set("extruder", 2, true);
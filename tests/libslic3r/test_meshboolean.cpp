@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <test_utils.hpp>
 
 #include <libslic3r/TriangleMesh.hpp>
@@ -51,3 +52,101 @@ TEST_CASE("Add TriangleMeshes", "[MeshBoolean]")
     //its_write_obj(tm1.its, "test_add.obj");
     CHECK(tm1.its.indices.size() > init_size);
 }
+
+TEST_CASE("Booleans of meshes with disjoint surfaces", "[MeshBoolean]")
+{
+    TriangleMesh big   = make_sphere(2., PI / 16.);
+    TriangleMesh small = make_sphere(1., PI / 16.);
+
+    SECTION("Separated meshes") {
+        small.translate(5., 0., 0.);
+
+        TriangleMesh r = big;
+        MeshBoolean::cgal::plus(r, small);
+        CHECK(r.volume() == Approx(big.volume() + small.volume()));
+
+        r = big;
+        MeshBoolean::cgal::minus(r, small);
+        CHECK(r.volume() == Approx(big.volume()));
+
+        r = big;
+        MeshBoolean::cgal::intersect(r, small);
+        CHECK(r.empty());
+    }
+
+    SECTION("Nested meshes") {
+        small.translate(0.1, 0.2, 0.3);
+
+        TriangleMesh r = big;
+        MeshBoolean::cgal::plus(r, small);
+        CHECK(r.volume() == Approx(big.volume()));
+
+        r = big;
+        MeshBoolean::cgal::minus(r, small);
+        CHECK(r.volume() == Approx(big.volume() - small.volume()));
+        CHECK(r.its.indices.size() == big.its.indices.size() + small.its.indices.size());
+
+        r = big;
+        MeshBoolean::cgal::intersect(r, small);
+        CHECK(r.volume() == Approx(small.volume()));
+
+        r = small;
+        MeshBoolean::cgal::minus(r, big);
+        CHECK(r.empty());
+    }
+
+    SECTION("Same volumes as by corefinement") {
+        small.translate(0.1, 0.2, 0.3);
+
+        auto volumes = [&big, &small]() {
+            std::array<double, 3> out;
+            TriangleMesh r = big;
+            MeshBoolean::cgal::plus(r, small);
+            out[0] = r.volume();
+            r = big;
+            MeshBoolean::cgal::minus(r, small);
+            out[1] = r.volume();
+            r = big;
+            MeshBoolean::cgal::intersect(r, small);
+            out[2] = r.volume();
+            return out;
+        };
+
+        std::array<double, 3> fast = volumes();
+        MeshBoolean::cgal::set_disjoint_fast_path(false);
+        std::array<double, 3> corefined = volumes();
+        MeshBoolean::cgal::set_disjoint_fast_path(true);
+        for (size_t i = 0; i < fast.size(); ++i)
+            CHECK(fast[i] == Approx(corefined[i]));
+    }
+}
+
+TEST_CASE("Mesh boolean benchmark", "[MeshBoolean][.Benchmarks]")
+{
+    // Union of disjoint holes one by one as in SLA hollowing, resolved by
+    // the fast path for disjoint surfaces and by corefinement.
+    auto holes = [](double spacing) {
+        std::vector<TriangleMesh> ret;
+        for (size_t i = 0; i < 20; ++i) {
+            TriangleMesh hole = make_cylinder(1., 10., PI / 32.);
+            hole.translate(spacing * i, 0., 0.);
+            ret.emplace_back(std::move(hole));
+        }
+        return ret;
+    };
+
+    auto unite = [](const std::vector<TriangleMesh> &meshes) {
+        TriangleMesh ret;
+        for (const TriangleMesh &m : meshes)
+            MeshBoolean::cgal::plus(ret, m);
+        return ret;
+    };
+
+    std::vector<TriangleMesh> disjoint = holes(3.);
+
+    BENCHMARK("Union of disjoint holes") { return unite(disjoint); };
+
+    MeshBoolean::cgal::set_disjoint_fast_path(false);
+    BENCHMARK("Union of disjoint holes by corefinement") { return unite(disjoint); };
+    MeshBoolean::cgal::set_disjoint_fast_path(true);
+}
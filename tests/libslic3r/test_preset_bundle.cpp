@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include "libslic3r/AppConfig.hpp"
+#include "libslic3r/PresetBundle.hpp"
+#include "libslic3r/Utils.hpp"
+
+using namespace Slic3r;
+
+// Vendor config bundle with a single preset of each FFF type and a physical printer.
+static const char *vendor_bundle = R"(
+[vendor]
+name = Test
+config_version = 1.0.0
+config_update_url =
+
+[printer_model:TP]
+name = Test Printer
+variants = 0.4
+technology = FFF
+family = Test
+default_materials = Test PLA
+
+[print:Test Print]
+layer_height = 0.3
+
+[filament:Test PLA]
+temperature = 205
+
+[printer:Test Printer]
+printer_model = TP
+printer_variant = 0.4
+nozzle_diameter = 0.4
+gcode_flavor = marlin2
+
+[physical_printer:Test Host]
+preset_name = Test Printer
+print_host = 192.168.0.1
+)";
+
+static std::string read_file(const boost::filesystem::path &path)
+{
+    boost::nowide::ifstream ifs(path.string(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const boost::filesystem::path &path, const std::string &data)
+{
+    boost::nowide::ofstream ofs(path.string(), std::ios::binary);
+    ofs << data;
+}
+
+// Options of the two configs have the same values and the same classes.
+static void check_configs_equal(const DynamicPrintConfig &lhs, const DynamicPrintConfig &rhs)
+{
+    REQUIRE(lhs.keys() == rhs.keys());
+    for (const std::string &key : lhs.keys()) {
+        INFO("Option " << key);
+        const ConfigOption *opt_lhs = lhs.option(key);
+        const ConfigOption *opt_rhs = rhs.option(key);
+        CHECK(typeid(*opt_lhs) == typeid(*opt_rhs));
+        CHECK(*opt_lhs == *opt_rhs);
+    }
+}
+
+static void check_bundles_equal(PresetBundle &lhs, PresetBundle &rhs)
+{
+    const std::pair<PresetCollection*, PresetCollection*> collections[] {
+        { &lhs.prints, &rhs.prints }, { &lhs.filaments, &rhs.filaments }, { &lhs.printers, &rhs.printers } };
+    for (auto [presets_lhs, presets_rhs] : collections) {
+        REQUIRE(std::distance(presets_lhs->begin(), presets_lhs->end()) == std::distance(presets_rhs->begin(), presets_rhs->end()));
+        for (const Preset &preset : *presets_lhs) {
+            INFO("Preset " << preset.name);
+            const Preset *other = presets_rhs->find_preset(preset.name);
+            REQUIRE(other != nullptr);
+            check_configs_equal(preset.config, other->config);
+        }
+    }
+    for (const PhysicalPrinter &printer : lhs.physical_printers) {
+        INFO("Physical printer " << printer.name);
+        const PhysicalPrinter *other = rhs.physical_printers.find_printer(printer.name);
+        REQUIRE(other != nullptr);
+        check_configs_equal(printer.config, other->config);
+    }
+}
+
+TEST_CASE("Vendor config bundles are cached as binary snapshots", "[PresetBundle]") {
+    const std::string             data_dir_saved = data_dir();
+    const boost::filesystem::path dir            = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    const boost::filesystem::path snapshot       = dir / "cache" / "system_presets" / "Test.cereal";
+    set_data_dir(dir.string());
+    PresetBundle().setup_directories();
+    write_file(dir / "vendor" / "Test.ini", vendor_bundle);
+
+    // Load the system presets and check the values of the vendor config bundle.
+    auto load = []() {
+        auto      bundle = std::make_unique<PresetBundle>();
+        AppConfig app_config(AppConfig::EAppMode::Editor);
+        bundle->load_presets(app_config, ForwardCompatibilitySubstitutionRule::Enable);
+        const Preset          *print         = bundle->prints.find_preset("Test Print");
+        const Preset          *printer       = bundle->printers.find_preset("Test Printer");
+        const PhysicalPrinter *phys_printer  = bundle->physical_printers.find_printer("Test Host");
+        REQUIRE(print != nullptr);
+        REQUIRE(print->is_system);
+        REQUIRE(printer != nullptr);
+        REQUIRE(phys_printer != nullptr);
+        CHECK(print->config.opt_float("layer_height") == 0.3);
+        CHECK(printer->config.opt_enum<GCodeFlavor>("gcode_flavor") == gcfMarlinFirmware);
+        // The physical printers hold typed enum options, whose underlying type is narrower than int.
+        REQUIRE(dynamic_cast<const ConfigOptionEnum<PrinterTechnology>*>(phys_printer->config.option("printer_technology")) != nullptr);
+        CHECK(phys_printer->config.opt_enum<PrinterTechnology>("printer_technology") == ptFFF);
+        CHECK(phys_printer->config.opt_string("print_host") == "192.168.0.1");
+        return bundle;
+    };
+    // Timestamp to tell whether the snapshot was rewritten.
+    const std::time_t  old_time = std::time(nullptr) - 24 * 3600;
+
+    // The vendor config bundle is parsed and a snapshot is written.
+    std::unique_ptr<PresetBundle> parsed = load();
+    REQUIRE(boost::filesystem::exists(snapshot));
+    const std::string data = read_file(snapshot);
+
+    // The snapshot is read back, it is not rewritten. The bundle loaded from it matches the parsed one.
+    boost::filesystem::last_write_time(snapshot, old_time);
+    std::unique_ptr<PresetBundle> cached = load();
+    CHECK(boost::filesystem::last_write_time(snapshot) == old_time);
+    check_bundles_equal(*parsed, *cached);
+
+    // A snapshot written by another build is stale: the vendor config bundle is parsed and the snapshot is rewritten.
+    std::string other_build = data;
+    for (size_t i = 0; i < sizeof(uint64_t); ++ i)
+        other_build[i] = ~ other_build[i];
+    write_file(snapshot, other_build);
+    boost::filesystem::last_write_time(snapshot, old_time);
+    load();
+    CHECK(boost::filesystem::last_write_time(snapshot) != old_time);
+    CHECK(read_file(snapshot) == data);
+
+    set_data_dir(data_dir_saved);
+    boost::filesystem::remove_all(dir);
+}
@@ -240,6 +240,26 @@ TEST_CASE("Simplify frog_legs.obj to 5% by Quadric edge collapse", "[its][quadri
     Private::is_better_similarity(mesh.its, its, Private::frog_leg_5);
 }
 
+TEST_CASE("Simplify frog_legs.obj to 5% by partitioned Quadric edge collapse", "[its][quadric_edge_collapse]")
+{
+    TriangleMesh mesh            = load_model("frog_legs.obj");
+    double       original_volume = its_volume(mesh.its);
+    uint32_t     wanted_count    = mesh.its.indices.size() * 0.05;
+    REQUIRE_FALSE(mesh.empty());
+    indexed_triangle_set its       = mesh.its; // copy
+    float                max_error = std::numeric_limits<float>::max();
+    // small parts to have a lot of seams
+    size_t partition_triangle_count = 2000;
+    its_quadric_edge_collapse_partitioned(its, wanted_count, &max_error, nullptr, nullptr, partition_triangle_count);
+    CHECK(its.indices.size() <= wanted_count);
+    CHECK(!Private::exist_triangle_with_twice_vertices(its.indices));
+    double volume = its_volume(its);
+    CHECK(fabs(original_volume - volume) < 33.);
+
+    // Hausdorff distance is bounded the same way as for the serial simplification
+    Private::is_better_similarity(mesh.its, its, Private::frog_leg_5);
+}
+
 TEST_CASE("Simplify frog_legs.obj to 5% by IGL/qslim", "[its]")
 {
     std::string  obj_filename    = "frog_legs.obj";
@@ -0,0 +1,41 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "libslic3r/GCode/ThumbnailRenderer.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+using namespace Slic3r;
+
+static unsigned char alpha_at(const ThumbnailData &thumbnail, unsigned int x, unsigned int y)
+{
+    return thumbnail.pixels[4 * (y * thumbnail.width + x) + 3];
+}
+
+TEST_CASE("Software thumbnail of a cube", "[Thumbnails]") {
+    const indexed_triangle_set cube = its_make_cube(10., 10., 10.);
+    const std::vector<GCodeThumbnails::ThumbnailMesh> meshes{ { &cube, Transform3d::Identity() } };
+
+    SECTION("Transparent background") {
+        ThumbnailData thumbnail = GCodeThumbnails::render_thumbnail(meshes, 64, 48, true);
+        REQUIRE(thumbnail.is_valid());
+        CHECK(thumbnail.width == 64);
+        CHECK(thumbnail.height == 48);
+        // The cube is zoomed to fit the image, leaving the corners empty.
+        CHECK(alpha_at(thumbnail, 32, 24) == 255);
+        CHECK(alpha_at(thumbnail, 0, 0) == 0);
+        CHECK(alpha_at(thumbnail, 63, 47) == 0);
+    }
+
+    SECTION("Opaque background") {
+        ThumbnailData thumbnail = GCodeThumbnails::render_thumbnail(meshes, 32, 32, false);
+        REQUIRE(thumbnail.is_valid());
+        for (unsigned int y = 0; y < thumbnail.height; ++ y)
+            for (unsigned int x = 0; x < thumbnail.width; ++ x)
+                CHECK(alpha_at(thumbnail, x, y) == 255);
+    }
+
+    SECTION("Empty scene") {
+        ThumbnailData thumbnail = GCodeThumbnails::render_thumbnail({}, 16, 16, true);
+        REQUIRE(thumbnail.is_valid());
+        CHECK(alpha_at(thumbnail, 8, 8) == 0);
+    }
+}
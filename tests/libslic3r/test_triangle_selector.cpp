@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleSelector.hpp"
+
+using namespace Slic3r;
+
+namespace {
+
+// Exposes the bucket fill internals to the tests.
+class TriangleSelectorTest : public TriangleSelector
+{
+public:
+    using TriangleSelector::TriangleSelector;
+    using TriangleSelector::TouchingTriangles;
+    using TriangleSelector::append_all_touching_triangles;
+    using TriangleSelector::collect_touching_triangles;
+
+    void set_bucket_fill_parallel_front_size(size_t size) { m_bucket_fill_parallel_front_size = size; }
+
+    size_t num_triangles() const { return m_triangles.size(); }
+    bool   is_leaf(int facet_idx) const { return m_triangles[facet_idx].valid() && !m_triangles[facet_idx].is_split(); }
+
+    std::vector<int> selected_by_seed_fill() const
+    {
+        std::vector<int> out;
+        for (int facet_idx = 0; facet_idx < int(m_triangles.size()); ++facet_idx)
+            if (this->is_leaf(facet_idx) && m_triangles[facet_idx].is_selected_by_seed_fill())
+                out.emplace_back(facet_idx);
+        return out;
+    }
+};
+
+Vec3f facet_centroid(const TriangleMesh &mesh, int facet_idx)
+{
+    const stl_triangle_vertex_indices &face = mesh.its.indices[facet_idx];
+    return (mesh.its.vertices[face(0)] + mesh.its.vertices[face(1)] + mesh.its.vertices[face(2)]) / 3.f;
+}
+
+// Paints a few spherical patches with triangle splitting, thus the selector holds leaf triangles of various sizes.
+void paint_patches(TriangleSelector &selector, const TriangleMesh &mesh)
+{
+    const TriangleStateType states[] = { TriangleStateType::ENFORCER, TriangleStateType::BLOCKER };
+    for (int i = 0; i < 6; ++i) {
+        const int   facet_idx = (i * 97) % int(mesh.its.indices.size());
+        const Vec3f center    = facet_centroid(mesh, facet_idx);
+        selector.select_patch(facet_idx,
+                              std::make_unique<TriangleSelector::Sphere>(center, 3.f * center, 2.f, Transform3d::Identity(), TriangleSelector::ClippingPlane()),
+                              states[i % 2], Transform3d::Identity(), true);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Touching triangles collected for bucket fill match the per facet query", "[TriangleSelector]")
+{
+    TriangleMesh         mesh(its_make_sphere(10., PI / 20.));
+    TriangleSelectorTest selector(mesh);
+    paint_patches(selector, mesh);
+    REQUIRE(selector.num_triangles() > mesh.its.indices.size());
+
+    const TriangleSelectorTest::TouchingTriangles touching_triangles = selector.collect_touching_triangles();
+    const auto [neighbors, neighbors_propagated]                     = selector.precompute_all_neighbors();
+    for (int facet_idx = 0; facet_idx < int(selector.num_triangles()); ++facet_idx) {
+        const auto [touching_begin, touching_end] = touching_triangles[facet_idx];
+        const std::vector<int> cached(touching_begin, touching_end);
+        if (!selector.is_leaf(facet_idx)) {
+            CHECK(cached.empty());
+            continue;
+        }
+
+        std::vector<int> uncached;
+        selector.append_all_touching_triangles(facet_idx, neighbors[facet_idx], neighbors_propagated[facet_idx], uncached);
+        CHECK(cached == uncached);
+        for (const int touching_idx : cached)
+            CHECK((touching_idx < 0 || selector.is_leaf(touching_idx)));
+    }
+}
+
+TEST_CASE("Parallel bucket fill selects the same triangles as the serial one", "[TriangleSelector]")
+{
+    TriangleMesh         mesh(its_make_sphere(10., PI / 20.));
+    TriangleSelectorTest painted(mesh);
+    paint_patches(painted, mesh);
+    const TriangleSelector::TriangleSplittingData data = painted.serialize();
+
+    TriangleSelectorTest serial(mesh);
+    TriangleSelectorTest parallel(mesh);
+    serial.deserialize(data);
+    parallel.deserialize(data);
+    serial.set_bucket_fill_parallel_front_size(std::numeric_limits<size_t>::max());
+    parallel.set_bucket_fill_parallel_front_size(1);
+
+    for (int start_facet : { 0, 97, 194, 300, 485 }) {
+        const Vec3f hit = facet_centroid(mesh, start_facet);
+        for (TriangleSelectorTest *selector : { &serial, &parallel })
+            selector->bucket_fill_select_triangles(hit, start_facet, TriangleSelector::ClippingPlane(), 30.f, 2.f,
+                                                   TriangleSelector::BucketFillPropagate::YES, TriangleSelector::ForceReselection::YES);
+
+        const std::vector<int> selected = serial.selected_by_seed_fill();
+        CHECK(!selected.empty());
+        CHECK(selected == parallel.selected_by_seed_fill());
+    }
+
+    serial.seed_fill_apply_on_triangles(TriangleStateType::ENFORCER);
+    parallel.seed_fill_apply_on_triangles(TriangleStateType::ENFORCER);
+    CHECK(serial.serialize() == parallel.serialize());
+}
@@ -215,6 +215,40 @@ TEST_CASE("halfcone test", "[halfcone]") {
     its_write_obj(m, "Halfcone.obj");
 }
 
+TEST_CASE("Support tree sliced from primitives matches the sliced mesh", "[SLASupportGeneration]") {
+    sla::SupportTreeBuilder builder;
+
+    sla::Head &head = builder.add_head(0, 0.5, 0.2, 1., 0.5,
+                                       Vec3d{0.3, -0.2, -1.}.normalized(),
+                                       Vec3d{0., 0., 20.});
+    long pillar_id = builder.add_pillar(head.id, 12.);
+    builder.add_pillar_base(pillar_id, 1., 2.);
+    builder.add_head(1, 0.5, 0.2, 1., 0.5, Vec3d{0., 0., -1.}, Vec3d{5., 5., 18.});
+    builder.add_junction(Vec3d{5., 5., 14.}, 0.5);
+    builder.add_bridge(1, Vec3d{5., 5., 14.});
+    builder.add_crossbridge(Vec3d{0., 0., 8.}, Vec3d{5., 5., 12.}, 0.4);
+    builder.add_diffbridge(Vec3d{5., 5., 14.}, Vec3d{-3., 2., 6.}, 0.5, 0.3);
+
+    std::vector<float> slicegrid = grid(0.05f, 22.f, 0.05f);
+
+    std::vector<ExPolygons> mesh_slices =
+        sla::slice(builder.retrieve_mesh(sla::MeshType::Support), {}, slicegrid, CLOSING_RADIUS, {});
+    std::vector<ExPolygons> prim_slices =
+        sla::slice(builder.primitives(), {}, slicegrid, CLOSING_RADIUS, {});
+
+    REQUIRE(prim_slices.size() == mesh_slices.size());
+
+    for (size_t i = 0; i < slicegrid.size(); ++i) {
+        double a_mesh = area(mesh_slices[i]);
+        double a_diff = area(diff_ex(mesh_slices[i], prim_slices[i])) +
+                        area(diff_ex(prim_slices[i], mesh_slices[i]));
+
+        // Both are polygonal approximations of the same solids, they differ
+        // by the placement of the polygon vertices only.
+        CHECK(a_diff <= 0.05 * a_mesh + scaled<double>(0.1) * scaled<double>(0.1));
+    }
+}
+
 TEST_CASE("Test concurrency")
 {
     std::vector<double> vals = grid(0., 100., 10.);
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include <random>
+
+#include "libslic3r/Geometry.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "slic3r/GUI/SceneRaycaster.hpp"
+
+using namespace Slic3r;
+using namespace Slic3r::GUI;
+
+namespace {
+
+// Grid of randomly rotated and scaled spheres with a set of pick rays recorded
+// from a camera looking at the plate from above its corner.
+struct PickingScene
+{
+    MeshRaycaster raycaster{ TriangleMesh{ its_make_sphere(5., PI / 16.) } };
+    std::vector<std::shared_ptr<SceneRaycasterItem>> items;
+    std::vector<std::pair<Vec3d, Vec3d>> rays;
+
+    PickingScene(size_t grid_size, size_t rays_count)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> angle(0., 2. * PI);
+        std::uniform_real_distribution<double> scale(0.5, 1.5);
+
+        for (size_t i = 0; i < grid_size; ++i)
+            for (size_t j = 0; j < grid_size; ++j) {
+                const Transform3d trafo = Geometry::translation_transform(Vec3d(15. * i, 15. * j, 5.)) *
+                                          Geometry::rotation_transform(Vec3d(0., 0., angle(rng))) *
+                                          Geometry::scale_transform(Vec3d(scale(rng), scale(rng), 1.));
+                items.emplace_back(std::make_shared<SceneRaycasterItem>(int(items.size()), raycaster, trafo));
+            }
+
+        const Vec3d eye(-100., -100., 300.);
+        std::uniform_real_distribution<double> coord(-10., 15. * grid_size);
+        for (size_t i = 0; i < rays_count; ++i)
+            rays.emplace_back(eye, (Vec3d(coord(rng), coord(rng), 0.) - eye).normalized());
+    }
+};
+
+bool is_hit(const SceneRaycasterItem& item, const Vec3d& point, const Vec3d& direction)
+{
+    const Transform3d inv = item.get_transform().inverse();
+    return !item.get_raycaster()->get_aabb_mesh().query_ray_hits(inv * point, (inv.linear() * direction).normalized()).empty();
+}
+
+void check_candidates(const PickingScene& scene, const SceneRaycasterTree& tree)
+{
+    std::vector<size_t> candidates;
+    size_t candidates_count = 0;
+    for (const auto& [point, direction] : scene.rays) {
+        tree.candidates(point, direction, candidates);
+        REQUIRE(std::is_sorted(candidates.begin(), candidates.end()));
+        candidates_count += candidates.size();
+
+        for (size_t i = 0; i < scene.items.size(); ++i) {
+            if (is_hit(*scene.items[i], point, direction))
+                REQUIRE(std::binary_search(candidates.begin(), candidates.end(), i));
+        }
+    }
+
+    // Only a small part of the scene shall be tested for each ray.
+    CHECK(candidates_count < scene.rays.size() * scene.items.size() / 4);
+}
+
+} // namespace
+
+TEST_CASE("Scene raycaster tree returns all the items hit by a ray", "[SceneRaycaster]")
+{
+    PickingScene scene(16, 200);
+
+    SceneRaycasterTree tree;
+    REQUIRE(tree.update(scene.items));
+    REQUIRE(tree.size() == scene.items.size());
+    REQUIRE(!tree.update(scene.items));
+
+    check_candidates(scene, tree);
+
+    SECTION("Moved items are found at their new position") {
+        for (size_t i = 0; i < scene.items.size(); i += 7)
+            scene.items[i]->set_transform(Geometry::translation_transform(Vec3d(-20., 0., 0.)) * scene.items[i]->get_transform());
+
+        REQUIRE(tree.update(scene.items));
+        check_candidates(scene, tree);
+    }
+
+    SECTION("Removed items are not returned") {
+        scene.items.erase(scene.items.begin() + 10, scene.items.begin() + 50);
+
+        REQUIRE(tree.update(scene.items));
+        REQUIRE(tree.size() == scene.items.size());
+        check_candidates(scene, tree);
+    }
+
+    SECTION("Items are found along nearly axis parallel rays") {
+        // The x and y components of the direction are tiny, but not zero. The rays start far above the items,
+        // outside of their boxes in x and y.
+        scene.rays.clear();
+        const Vec3d direction = Vec3d(5e-5, -5e-5, -1.).normalized();
+        for (size_t i = 0; i < scene.items.size(); i += 13)
+            scene.rays.emplace_back(scene.items[i]->get_transform().translation() - 1e6 * direction, direction);
+
+        check_candidates(scene, tree);
+    }
+}
+
+TEST_CASE("Scene raycaster picking benchmark", "[SceneRaycaster][.Benchmarks]")
+{
+    PickingScene scene(20, 1000);
+
+    SceneRaycasterTree tree;
+    tree.update(scene.items);
+
+    BENCHMARK("Test all the items") {
+        size_t hits = 0;
+        for (const auto& [point, direction] : scene.rays)
+            for (const std::shared_ptr<SceneRaycasterItem>& item : scene.items)
+                hits += is_hit(*item, point, direction);
+        return hits;
+    };
+
+    BENCHMARK("Test the items returned by the tree") {
+        size_t hits = 0;
+        std::vector<size_t> candidates;
+        for (const auto& [point, direction] : scene.rays) {
+            tree.candidates(point, direction, candidates);
+            for (size_t idx : candidates)
+                hits += is_hit(*scene.items[idx], point, direction);
+        }
+        return hits;
+    };
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "slic3r/Utils/UndoRedoHistory.hpp"
+
+using namespace Slic3r::UndoRedo;
+
+TEST_CASE("Memory of delta encoded mutable snapshots", "[UndoRedo]") {
+    // Successive snapshots differ in a single byte, thus they are stored as a chain of deltas against the first one.
+    std::string data0(1000, 'a');
+    std::string data1 = data0;
+    data1[500] = 'b';
+    std::string data2 = data1;
+    data2[600] = 'c';
+
+    MutableObjectHistory<std::string> history;
+    history.save(0, 0, data0);
+    const size_t memsize0 = history.memsize();
+    history.save(1, 1, data1);
+    const size_t memsize1 = history.memsize();
+    history.save(2, 2, data2);
+    const size_t memsize2 = history.memsize();
+
+    // The full snapshot referenced by a delta is still charged in full, the deltas are cheap.
+    REQUIRE(memsize0 > data0.size());
+    REQUIRE(memsize1 > memsize0);
+    REQUIRE(memsize1 < memsize0 + data1.size() / 2);
+    REQUIRE(memsize2 > memsize1);
+    REQUIRE(memsize2 < memsize1 + data2.size() / 2);
+
+    SECTION("Releasing the base snapshots kept alive by a delta frees their intervals only") {
+        const size_t released = history.release_before_timestamp(2);
+        REQUIRE(released == 2 * sizeof(MutableHistoryInterval));
+        REQUIRE(history.memsize() == memsize2 - released);
+        REQUIRE(history.load(2) == data2);
+
+        AND_THEN("Releasing the last delta frees the whole chain") {
+            const size_t released_chain = history.release_before_timestamp(3);
+            REQUIRE(history.empty());
+            REQUIRE(history.memsize() == memsize2 - released - released_chain);
+        }
+    }
+
+    SECTION("Releasing the deltas keeps the base snapshot") {
+        const size_t released = history.release_after_timestamp(1);
+        REQUIRE(history.memsize() == memsize2 - released);
+        REQUIRE(history.memsize() == memsize0);
+        REQUIRE(history.load(0) == data0);
+    }
+
+    SECTION("Releasing a delta in the middle of the chain keeps its data referenced by the next delta") {
+        const size_t released = history.release_between_timestamps(0, 2);
+        REQUIRE(released == sizeof(MutableHistoryInterval));
+        REQUIRE(history.memsize() == memsize2 - released);
+        REQUIRE(history.load(0) == data0);
+        REQUIRE(history.load(2) == data2);
+    }
+}